@@ -0,0 +1,18 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM contributors <kde-pim@kde.org>
+
+  SPDX-License-Identifier: GPL-2.0-or-later WITH LicenseRef-Qt-Commercial-exception-1.0
+*/
+
+#pragma once
+
+#include "eventviews_export.h"
+
+/* Classes which are exported only for unit tests */
+#ifdef BUILD_TESTING
+#ifndef EVENTVIEWS_TESTS_EXPORT
+#define EVENTVIEWS_TESTS_EXPORT EVENTVIEWS_EXPORT
+#endif
+#else /* not compiling tests */
+#define EVENTVIEWS_TESTS_EXPORT
+#endif
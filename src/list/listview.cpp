@@ -19,6 +19,7 @@
 #include <Akonadi/IncidenceChanger>
 
 #include <KCalUtils/IncidenceFormatter>
+#include <KCalendarCore/OccurrenceIterator>
 #include <KCalendarCore/Visitor>
 
 #include <KConfig>
@@ -30,6 +31,7 @@
 #include <QHeaderView>
 #include <QIcon>
 #include <QLocale>
+#include <QSet>
 #include <QTreeWidget>
 
 using namespace EventViews;
@@ -369,14 +371,25 @@ void ListView::showDates(const QDate &start, const QDate &end, const QDate &pref
 
     d->mTreeWidget->headerItem()->setText(Summary_Column, i18n("Summary [%1 - %2]", startStr, endStr));
 
-    QDate date = start;
+    // One pass over the occurrences of the whole range per calendar. Each
+    // incidence gets a single row, dated with the first day it occurs on.
     const auto cals = calendars();
-    while (date <= end) {
-        for (const auto &calendar : cals) {
-            d->addIncidences(calendar, calendar->incidences(date), date);
+    for (const auto &calendar : cals) {
+        QSet<KCalendarCore::Incidence *> listedIncidences;
+        KCalendarCore::OccurrenceIterator occurIter(*calendar, start.startOfDay(), end.endOfDay());
+        while (occurIter.hasNext()) {
+            occurIter.next();
+            const KCalendarCore::Incidence::Ptr incidence = occurIter.incidence();
+            if (listedIncidences.contains(incidence.data())) {
+                continue;
+            }
+            listedIncidences.insert(incidence.data());
+            d->addIncidence(calendar, incidence, std::max(occurIter.occurrenceStartDate().toLocalTime().date(), start));
         }
+    }
+
+    for (QDate date = start; date <= end; date = date.addDays(1)) {
         d->mSelectedDates.append(date);
-        date = date.addDays(1);
     }
 
     updateView();
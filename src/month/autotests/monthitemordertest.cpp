@@ -19,10 +19,12 @@ private Q_SLOTS:
 
     void longerInstancesFirst();
     void holidaysFirst();
+    void earlierStartTimeFirst();
     void stableOrder();
 
 public:
     std::unique_ptr<IncidenceMonthItem> eventItem(QDate start, QDate end);
+    std::unique_ptr<IncidenceMonthItem> timedEventItem(const QDateTime &start, const QDateTime &end);
 };
 
 /**
@@ -63,6 +65,22 @@ void MonthItemOrderTest::holidaysFirst()
     QVERIFY(MonthItem::greaterThan(holiday.get(), event.get()));
 }
 
+/**
+ * Timed events of the same length and day are placed in the order of their
+ * start times, after the all-day ones.
+ */
+void MonthItemOrderTest::earlierStartTimeFirst()
+{
+    const QDate startDate(2000, 01, 01);
+    const auto allDayEvent = eventItem(startDate, startDate);
+    const auto morningEvent = timedEventItem(QDateTime(startDate, QTime(9, 0)), QDateTime(startDate, QTime(10, 0)));
+    const auto eveningEvent = timedEventItem(QDateTime(startDate, QTime(18, 0)), QDateTime(startDate, QTime(19, 0)));
+    QVERIFY(MonthItem::greaterThan(allDayEvent.get(), morningEvent.get()));
+    QVERIFY(!MonthItem::greaterThan(morningEvent.get(), allDayEvent.get()));
+    QVERIFY(MonthItem::greaterThan(morningEvent.get(), eveningEvent.get()));
+    QVERIFY(!MonthItem::greaterThan(eveningEvent.get(), morningEvent.get()));
+}
+
 /**
  * If two holidays are on the same day, they do not both come before the other.
  * Similarly for two events with the same length and start day.
@@ -88,6 +106,14 @@ std::unique_ptr<IncidenceMonthItem> MonthItemOrderTest::eventItem(QDate start, Q
     e->setAllDay(true);
     return std::make_unique<IncidenceMonthItem>(nullptr, nullptr, Akonadi::Item(), KCalendarCore::Event::Ptr(e), start);
 }
+
+std::unique_ptr<IncidenceMonthItem> MonthItemOrderTest::timedEventItem(const QDateTime &start, const QDateTime &end)
+{
+    auto e = new KCalendarCore::Event;
+    e->setDtStart(start);
+    e->setDtEnd(end);
+    return std::make_unique<IncidenceMonthItem>(nullptr, nullptr, Akonadi::Item(), KCalendarCore::Event::Ptr(e), start.date());
+}
 }
 
 QTEST_MAIN(MonthItemOrderTest)
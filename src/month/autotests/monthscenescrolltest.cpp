@@ -0,0 +1,205 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KDE PIM contributors <kde-pim@kde.org>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <QTest>
+
+#include "../monthgraphicsitems.h"
+#include "../monthitem.h"
+#include "../monthscene.h"
+#include "../monthview.h"
+
+#include <QSet>
+
+using namespace EventViews;
+
+namespace
+{
+class MonthSceneScrollTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void gridFollowsWeeks();
+    void scrollKeepsCellsAndItems();
+    void revealedRowsGetItems();
+
+public:
+    static void fillCells(MonthScene &scene, QDate gridStart);
+    [[nodiscard]] static const MonthOccurrence *occurrence(const MonthScene &scene, const QString &name);
+    [[nodiscard]] static QDate gridStart(const MonthView &view);
+};
+
+const QDate firstDay(2026, 3, 4); // a Wednesday, never the first day of a week
+
+void MonthSceneScrollTest::fillCells(MonthScene &scene, QDate gridStart)
+{
+    for (int i = 0; i < 6 * 7; ++i) {
+        const QDate date = gridStart.addDays(i);
+        scene.mMonthCellMap.insert(date, new MonthCell(i, date, &scene));
+    }
+}
+
+const MonthOccurrence *MonthSceneScrollTest::occurrence(const MonthScene &scene, const QString &name)
+{
+    for (const MonthOccurrence &occurrence : scene.occurrences()) {
+        if (occurrence.holidayName == name) {
+            return &occurrence;
+        }
+    }
+    return nullptr;
+}
+
+QDate MonthSceneScrollTest::gridStart(const MonthView &view)
+{
+    return view.actualStartDateTime().date();
+}
+
+/**
+ * With continuous scrolling the grid begins with the week of the first day
+ * shown, so moving by a week moves it by a week. Without, it begins with the
+ * week of the first day of the month.
+ */
+void MonthSceneScrollTest::gridFollowsWeeks()
+{
+    MonthView view(MonthView::Hidden);
+    QVERIFY(!view.continuousScrolling());
+    view.setContinuousScrolling(true);
+    QVERIFY(view.continuousScrolling());
+
+    view.setDateRange(firstDay.startOfDay(), firstDay.addDays(30).endOfDay());
+    const QDate start = gridStart(view);
+    QVERIFY(start <= firstDay);
+    QVERIFY(start.daysTo(firstDay) < 7);
+    QCOMPARE(view.actualStartDateTime().daysTo(view.actualEndDateTime()), 6 * 7 - 1);
+
+    view.setDateRange(firstDay.addDays(7).startOfDay(), firstDay.addDays(37).endOfDay());
+    QCOMPARE(gridStart(view), start.addDays(7));
+
+    view.setContinuousScrolling(false);
+    const QDate monthStart = gridStart(view);
+    QVERIFY(monthStart <= QDate(2026, 3, 1));
+    QVERIFY(monthStart.daysTo(QDate(2026, 3, 1)) < 7);
+
+    // Within the month, the grid doesn't move anymore
+    view.setDateRange(firstDay.startOfDay(), firstDay.addDays(30).endOfDay());
+    QCOMPARE(gridStart(view), monthStart);
+}
+
+/**
+ * Scrolling by a week reuses the cells of the week scrolled out for the
+ * exposed one, and keeps the cells, occurrences and items of the other weeks.
+ */
+void MonthSceneScrollTest::scrollKeepsCellsAndItems()
+{
+    MonthView view(MonthView::Hidden);
+    view.setContinuousScrolling(true);
+    view.setDateRange(firstDay.startOfDay(), firstDay.addDays(30).endOfDay());
+    const QDate start = gridStart(view);
+
+    MonthScene scene(&view);
+    scene.setSceneRect(0, 0, 700, 700);
+    QVERIFY(scene.maxRowCount() > 0);
+    fillCells(scene, start);
+    scene.addHolidayOccurrence(start.addDays(2), start.addDays(2), QStringLiteral("dropped"));
+    scene.addHolidayOccurrence(start.addDays(5), start.addDays(9), QStringLiteral("crossing"));
+    scene.addHolidayOccurrence(start.addDays(15), start.addDays(15), QStringLiteral("kept"));
+    scene.layoutOccurrences();
+    scene.createVisibleMonthItems();
+
+    const QMap<QDate, MonthCell *> cellsBefore = scene.mMonthCellMap;
+    MonthItem *const crossingItem = occurrence(scene, QStringLiteral("crossing"))->monthItem;
+    MonthItem *const keptItem = occurrence(scene, QStringLiteral("kept"))->monthItem;
+    QVERIFY(crossingItem);
+    QVERIFY(keptItem);
+    QVERIFY(occurrence(scene, QStringLiteral("dropped"))->monthItem);
+
+    const QDate newStart = start.addDays(7);
+    view.setDateRange(firstDay.addDays(7).startOfDay(), firstDay.addDays(37).endOfDay());
+    QCOMPARE(gridStart(view), newStart);
+    scene.scrollWeeks(newStart, newStart, start.addDays(41));
+
+    // Kept cells are the same objects, moved up by a row and emptied
+    QCOMPARE(scene.mMonthCellMap.size(), 6 * 7);
+    QCOMPARE(scene.mMonthCellMap.firstKey(), newStart);
+    QCOMPARE(scene.mMonthCellMap.lastKey(), newStart.addDays(6 * 7 - 1));
+    for (int i = 0; i < 6 * 7; ++i) {
+        const QDate date = newStart.addDays(i);
+        MonthCell *cell = scene.mMonthCellMap.value(date);
+        QVERIFY(cell);
+        QCOMPARE(cell->date(), date);
+        QCOMPARE(cell->id(), i);
+        QCOMPARE(cell->firstFreeSpace(), 0);
+        if (i < 5 * 7) {
+            QCOMPARE(cell, cellsBefore.value(date));
+        }
+    }
+
+    // The cells of the exposed week are the ones scrolled out
+    QSet<MonthCell *> scrolledOut;
+    QSet<MonthCell *> exposed;
+    for (int i = 0; i < 7; ++i) {
+        scrolledOut.insert(cellsBefore.value(start.addDays(i)));
+        exposed.insert(scene.mMonthCellMap.value(newStart.addDays(5 * 7 + i)));
+    }
+    QCOMPARE(exposed, scrolledOut);
+
+    // Only the occurrences crossing the kept weeks stay, with their items
+    QCOMPARE(scene.occurrences().size(), 2);
+    QVERIFY(!occurrence(scene, QStringLiteral("dropped")));
+    QCOMPARE(occurrence(scene, QStringLiteral("crossing"))->monthItem, crossingItem);
+    QCOMPARE(occurrence(scene, QStringLiteral("kept"))->monthItem, keptItem);
+
+    scene.addHolidayOccurrence(newStart.addDays(37), newStart.addDays(37), QStringLiteral("exposed"));
+    scene.layoutOccurrences();
+    scene.updateGeometry();
+    QVERIFY(occurrence(scene, QStringLiteral("exposed"))->monthItem);
+    QCOMPARE(scene.mMonthCellMap.value(newStart.addDays(37))->firstFreeSpace(), 1);
+    QCOMPARE(scene.mMonthCellMap.value(newStart.addDays(2))->firstFreeSpace(), 1);
+    QCOMPARE(scene.mMonthCellMap.value(newStart.addDays(3))->firstFreeSpace(), 0);
+}
+
+/**
+ * Items are only created for the rows in view, and for the rows revealed by
+ * scrolling the cells.
+ */
+void MonthSceneScrollTest::revealedRowsGetItems()
+{
+    MonthView view(MonthView::Hidden);
+    view.setDateRange(firstDay.startOfDay(), firstDay.addDays(30).endOfDay());
+    const QDate start = gridStart(view);
+
+    MonthScene scene(&view);
+    scene.setSceneRect(0, 0, 700, 700);
+    const int rows = scene.maxRowCount();
+    QVERIFY(rows > 0);
+    fillCells(scene, start);
+    const QDate crowded = start.addDays(22);
+    for (int i = 0; i <= rows; ++i) {
+        scene.addHolidayOccurrence(crowded, crowded, QString::number(i));
+    }
+    scene.layoutOccurrences();
+    scene.createVisibleMonthItems();
+
+    QCOMPARE(scene.mMonthCellMap.value(crowded)->firstFreeSpace(), rows + 1);
+    const MonthOccurrence *hidden = nullptr;
+    for (const MonthOccurrence &occurrence : scene.occurrences()) {
+        QCOMPARE(occurrence.monthItem != nullptr, occurrence.position < rows);
+        if (occurrence.position == rows) {
+            hidden = &occurrence;
+        }
+    }
+    QVERIFY(hidden);
+
+    scene.setStartHeight(1);
+    scene.updateGeometry();
+    QVERIFY(hidden->monthItem);
+    QVERIFY(scene.isRowVisible(hidden->position));
+}
+}
+
+QTEST_MAIN(MonthSceneScrollTest)
+
+#include "monthscenescrolltest.moc"
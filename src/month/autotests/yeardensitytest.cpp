@@ -0,0 +1,218 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KDE PIM contributors <kde-pim@kde.org>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <QTest>
+
+#include "../yeardensity.h"
+
+#include <KCalendarCore/Event>
+#include <KCalendarCore/MemoryCalendar>
+#include <KCalendarCore/Todo>
+
+using namespace EventViews;
+
+namespace
+{
+class YearDensityTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void timedEvents();
+    void transparentEvents();
+    void multiDayEvents();
+    void recurringEvents();
+    void hiddenTypes();
+    void addCapsBusyMinutes();
+
+public:
+    static KCalendarCore::Event::Ptr addEvent(const KCalendarCore::MemoryCalendar::Ptr &calendar, const QDateTime &start, const QDateTime &end);
+    static KCalendarCore::Event::Ptr addAllDayEvent(const KCalendarCore::MemoryCalendar::Ptr &calendar, QDate start, QDate end);
+    [[nodiscard]] static YearDensity aggregate(const KCalendarCore::MemoryCalendar::Ptr &calendar, bool showTodos = true);
+    [[nodiscard]] static int count(const YearDensity &density, QDate date);
+    [[nodiscard]] static int busyMinutes(const YearDensity &density, QDate date);
+};
+
+const QDate firstDay(2026, 1, 1);
+const QDate lastDay(2026, 12, 31);
+
+KCalendarCore::Event::Ptr YearDensityTest::addEvent(const KCalendarCore::MemoryCalendar::Ptr &calendar, const QDateTime &start, const QDateTime &end)
+{
+    KCalendarCore::Event::Ptr event(new KCalendarCore::Event);
+    event->setDtStart(start);
+    event->setDtEnd(end);
+    calendar->addEvent(event);
+    return event;
+}
+
+KCalendarCore::Event::Ptr YearDensityTest::addAllDayEvent(const KCalendarCore::MemoryCalendar::Ptr &calendar, QDate start, QDate end)
+{
+    KCalendarCore::Event::Ptr event(new KCalendarCore::Event);
+    event->setDtStart(start.startOfDay());
+    event->setDtEnd(end.startOfDay());
+    event->setAllDay(true);
+    calendar->addEvent(event);
+    return event;
+}
+
+YearDensity YearDensityTest::aggregate(const KCalendarCore::MemoryCalendar::Ptr &calendar, bool showTodos)
+{
+    const YearDensity density = YearDensity::aggregate(*calendar, firstDay, lastDay, showTodos, true);
+    const int dayCount = firstDay.daysTo(lastDay) + 1;
+    Q_ASSERT(density.counts.size() == dayCount);
+    Q_ASSERT(density.busyMinutes.size() == dayCount);
+    return density;
+}
+
+int YearDensityTest::count(const YearDensity &density, QDate date)
+{
+    return density.counts.at(firstDay.daysTo(date));
+}
+
+int YearDensityTest::busyMinutes(const YearDensity &density, QDate date)
+{
+    return density.busyMinutes.at(firstDay.daysTo(date));
+}
+
+/**
+ * A timed event counts once on its day and blocks its duration. Busy time
+ * of an event crossing midnight is split between both days.
+ */
+void YearDensityTest::timedEvents()
+{
+    KCalendarCore::MemoryCalendar::Ptr calendar(new KCalendarCore::MemoryCalendar(QTimeZone::systemTimeZone()));
+    const QDate day(2026, 3, 10);
+    addEvent(calendar, QDateTime(day, QTime(9, 0)), QDateTime(day, QTime(10, 30)));
+    addEvent(calendar, QDateTime(day, QTime(14, 0)), QDateTime(day, QTime(15, 0)));
+    const QDate night(2026, 3, 20);
+    addEvent(calendar, QDateTime(night, QTime(22, 0)), QDateTime(night.addDays(1), QTime(2, 0)));
+
+    const YearDensity density = aggregate(calendar);
+    QCOMPARE(count(density, day), 2);
+    QCOMPARE(busyMinutes(density, day), 150);
+    QCOMPARE(count(density, day.addDays(1)), 0);
+    QCOMPARE(busyMinutes(density, day.addDays(1)), 0);
+    QCOMPARE(count(density, night), 1);
+    QCOMPARE(busyMinutes(density, night), 120);
+    QCOMPARE(count(density, night.addDays(1)), 1);
+    QCOMPARE(busyMinutes(density, night.addDays(1)), 120);
+}
+
+/**
+ * Transparent events are counted but don't block any time.
+ */
+void YearDensityTest::transparentEvents()
+{
+    KCalendarCore::MemoryCalendar::Ptr calendar(new KCalendarCore::MemoryCalendar(QTimeZone::systemTimeZone()));
+    const QDate day(2026, 4, 7);
+    auto event = addEvent(calendar, QDateTime(day, QTime(9, 0)), QDateTime(day, QTime(17, 0)));
+    event->setTransparency(KCalendarCore::Event::Transparent);
+
+    const YearDensity density = aggregate(calendar);
+    QCOMPARE(count(density, day), 1);
+    QCOMPARE(busyMinutes(density, day), 0);
+}
+
+/**
+ * A multi-day event counts on each of its days, all day events block them
+ * entirely. Events sticking out of the year only count on its days.
+ */
+void YearDensityTest::multiDayEvents()
+{
+    KCalendarCore::MemoryCalendar::Ptr calendar(new KCalendarCore::MemoryCalendar(QTimeZone::systemTimeZone()));
+    const QDate start(2026, 5, 12);
+    addAllDayEvent(calendar, start, start.addDays(2));
+    addAllDayEvent(calendar, QDate(2025, 12, 30), QDate(2026, 1, 2));
+
+    const YearDensity density = aggregate(calendar);
+    QCOMPARE(count(density, start.addDays(-1)), 0);
+    for (int i = 0; i < 3; ++i) {
+        QCOMPARE(count(density, start.addDays(i)), 1);
+        QCOMPARE(busyMinutes(density, start.addDays(i)), 24 * 60);
+    }
+    QCOMPARE(count(density, start.addDays(3)), 0);
+
+    QCOMPARE(count(density, QDate(2026, 1, 1)), 1);
+    QCOMPARE(count(density, QDate(2026, 1, 2)), 1);
+    QCOMPARE(count(density, QDate(2026, 1, 3)), 0);
+    QCOMPARE(busyMinutes(density, QDate(2026, 1, 2)), 24 * 60);
+}
+
+/**
+ * Each occurrence of a recurring event counts on its own day.
+ */
+void YearDensityTest::recurringEvents()
+{
+    KCalendarCore::MemoryCalendar::Ptr calendar(new KCalendarCore::MemoryCalendar(QTimeZone::systemTimeZone()));
+    const QDate start(2026, 3, 2);
+    auto weekly = addEvent(calendar, QDateTime(start, QTime(10, 0)), QDateTime(start, QTime(11, 0)));
+    weekly->recurrence()->setWeekly(1);
+    weekly->recurrence()->setDuration(3);
+    auto twoDays = addAllDayEvent(calendar, QDate(2026, 6, 1), QDate(2026, 6, 2));
+    twoDays->recurrence()->setWeekly(1);
+    twoDays->recurrence()->setDuration(2);
+
+    const YearDensity density = aggregate(calendar);
+    for (int week = 0; week < 3; ++week) {
+        const QDate date = start.addDays(7 * week);
+        QCOMPARE(count(density, date), 1);
+        QCOMPARE(busyMinutes(density, date), 60);
+        QCOMPARE(count(density, date.addDays(1)), 0);
+    }
+    QCOMPARE(count(density, start.addDays(21)), 0);
+
+    // Two days long, twice
+    for (const QDate date : {QDate(2026, 6, 1), QDate(2026, 6, 2), QDate(2026, 6, 8), QDate(2026, 6, 9)}) {
+        QCOMPARE(count(density, date), 1);
+        QCOMPARE(busyMinutes(density, date), 24 * 60);
+    }
+    QCOMPARE(count(density, QDate(2026, 6, 3)), 0);
+    QCOMPARE(count(density, QDate(2026, 6, 15)), 0);
+}
+
+/**
+ * To-dos are left out when they are not shown.
+ */
+void YearDensityTest::hiddenTypes()
+{
+    KCalendarCore::MemoryCalendar::Ptr calendar(new KCalendarCore::MemoryCalendar(QTimeZone::systemTimeZone()));
+    const QDate day(2026, 8, 3);
+    KCalendarCore::Todo::Ptr todo(new KCalendarCore::Todo);
+    todo->setDtStart(QDateTime(day, QTime(9, 0)));
+    todo->setDtDue(QDateTime(day, QTime(12, 0)));
+    calendar->addTodo(todo);
+
+    QCOMPARE(count(aggregate(calendar, true), day), 1);
+    QCOMPARE(busyMinutes(aggregate(calendar, true), day), 0);
+    QCOMPARE(count(aggregate(calendar, false), day), 0);
+}
+
+/**
+ * Adding densities sums the counts and caps busy time at a full day.
+ */
+void YearDensityTest::addCapsBusyMinutes()
+{
+    KCalendarCore::MemoryCalendar::Ptr calendar(new KCalendarCore::MemoryCalendar(QTimeZone::systemTimeZone()));
+    const QDate day(2026, 9, 15);
+    addAllDayEvent(calendar, day, day);
+    addEvent(calendar, QDateTime(day, QTime(9, 0)), QDateTime(day, QTime(10, 0)));
+
+    const YearDensity single = aggregate(calendar);
+    QCOMPARE(count(single, day), 2);
+    QCOMPARE(busyMinutes(single, day), 24 * 60);
+
+    YearDensity sum;
+    sum.add(single);
+    sum.add(single);
+    QCOMPARE(count(sum, day), 4);
+    QCOMPARE(busyMinutes(sum, day), 24 * 60);
+    QCOMPARE(count(sum, day.addDays(1)), 0);
+}
+}
+
+QTEST_MAIN(YearDensityTest)
+
+#include "yeardensitytest.moc"
@@ -0,0 +1,74 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM contributors <kde-pim@kde.org>
+
+  SPDX-License-Identifier: GPL-2.0-or-later WITH LicenseRef-Qt-Commercial-exception-1.0
+*/
+
+#include "calendargroups.h"
+
+#include <QHash>
+
+#include <numeric>
+
+QList<QList<qsizetype>> EventViews::groupCalendarsBySharedIncidences(const QList<Akonadi::CollectionCalendar::Ptr> &calendars)
+{
+    // Union-find over the calendar indexes
+    QList<qsizetype> parents(calendars.size());
+    std::iota(parents.begin(), parents.end(), 0);
+    const auto root = [&parents](qsizetype index) {
+        while (parents.at(index) != index) {
+            parents[index] = parents.at(parents.at(index));
+            index = parents.at(index);
+        }
+        return index;
+    };
+
+    QHash<const KCalendarCore::Incidence *, qsizetype> owners;
+    for (qsizetype i = 0; i < calendars.size(); ++i) {
+        const KCalendarCore::Incidence::List incidences = calendars.at(i)->rawIncidences();
+        owners.reserve(owners.size() + incidences.size());
+        for (const KCalendarCore::Incidence::Ptr &incidence : incidences) {
+            const auto it = owners.constFind(incidence.data());
+            if (it == owners.cend()) {
+                owners.insert(incidence.data(), i);
+                continue;
+            }
+            const qsizetype first = root(it.value());
+            const qsizetype second = root(i);
+            if (first != second) {
+                parents[std::max(first, second)] = std::min(first, second);
+            }
+        }
+    }
+
+    // Roots are the smallest index of their group, so the groups come out
+    // in the order of their first calendar
+    QList<QList<qsizetype>> groups;
+    QHash<qsizetype, qsizetype> groupOfRoot;
+    for (qsizetype i = 0; i < calendars.size(); ++i) {
+        const qsizetype r = root(i);
+        const auto it = groupOfRoot.constFind(r);
+        if (it == groupOfRoot.cend()) {
+            groupOfRoot.insert(r, groups.size());
+            groups.append({i});
+        } else {
+            groups[it.value()].append(i);
+        }
+    }
+    return groups;
+}
+
+const QList<QList<qsizetype>> &EventViews::CalendarGroups::groups(const QList<Akonadi::CollectionCalendar::Ptr> &calendars)
+{
+    if (!mValid || calendars != mCalendars) {
+        mGroups = groupCalendarsBySharedIncidences(calendars);
+        mCalendars = calendars;
+        mValid = true;
+    }
+    return mGroups;
+}
+
+void EventViews::CalendarGroups::invalidate()
+{
+    mValid = false;
+}
@@ -0,0 +1,45 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM contributors <kde-pim@kde.org>
+
+  SPDX-License-Identifier: GPL-2.0-or-later WITH LicenseRef-Qt-Commercial-exception-1.0
+*/
+
+#pragma once
+
+#include <Akonadi/CollectionCalendar>
+
+#include <QList>
+
+namespace EventViews
+{
+/**
+  Splits @p calendars into groups such that no incidence is in calendars of
+  two different groups, and returns the indexes in @p calendars of each
+  group, in ascending order.
+
+  Expanding the occurrences of an incidence fills caches in its Recurrence,
+  and the payload of an item shown in several collections can be one shared
+  Incidence. So the groups can be expanded in parallel, but the calendars of
+  one group must be expanded one after the other.
+*/
+[[nodiscard]] QList<QList<qsizetype>> groupCalendarsBySharedIncidences(const QList<Akonadi::CollectionCalendar::Ptr> &calendars);
+
+/**
+  Keeps the result of groupCalendarsBySharedIncidences() between reloads.
+
+  Grouping goes through every incidence of every calendar, so it's only
+  done again once invalidate() was called, because a calendar or an
+  incidence was added or removed, or when asked for other calendars.
+*/
+class CalendarGroups
+{
+public:
+    [[nodiscard]] const QList<QList<qsizetype>> &groups(const QList<Akonadi::CollectionCalendar::Ptr> &calendars);
+    void invalidate();
+
+private:
+    QList<Akonadi::CollectionCalendar::Ptr> mCalendars;
+    QList<QList<qsizetype>> mGroups;
+    bool mValid = false;
+};
+}
@@ -15,6 +15,7 @@
 
 #include <QGraphicsScene>
 #include <QPainter>
+#include <QtAlgorithms>
 
 using namespace EventViews;
 
@@ -76,18 +77,30 @@ MonthCell::~MonthCell()
     delete mDownArrow;
 }
 
-bool MonthCell::hasEventBelow(int height)
+void MonthCell::reset(int id, QDate date)
 {
-    if (mHeightHash.isEmpty()) {
-        return false;
-    }
+    mId = id;
+    mDate = date;
+    mUsedRows.clear();
+    mUpArrow->hide();
+    mDownArrow->hide();
+}
 
-    for (int i = 0; i < height; ++i) {
-        if (mHeightHash.value(i) != nullptr) {
+bool MonthCell::hasEventBelow(int height) const
+{
+    const qsizetype fullWords = qMin<qsizetype>(height / 64, mUsedRows.size());
+    for (qsizetype i = 0; i < fullWords; ++i) {
+        if (mUsedRows[i] != 0) {
             return true;
         }
     }
 
+    const int remainingBits = height % 64;
+    if (remainingBits != 0 && fullWords < mUsedRows.size()) {
+        const quint64 lowBits = (quint64(1) << remainingBits) - 1;
+        return (mUsedRows[fullWords] & lowBits) != 0;
+    }
+
     return false;
 }
 
@@ -96,20 +109,38 @@ int MonthCell::topMargin()
     return 18;
 }
 
-void MonthCell::addMonthItem(MonthItem *manager, int height)
+void MonthCell::addMonthItem(int height)
+{
+    const qsizetype word = height / 64;
+    if (mUsedRows.size() <= word) {
+        mUsedRows.resize(word + 1, 0);
+    }
+    mUsedRows[word] |= quint64(1) << (height % 64);
+}
+
+void MonthCell::collectUsedRows(RowMask &mask) const
 {
-    mHeightHash[height] = manager;
+    if (mask.size() < mUsedRows.size()) {
+        mask.resize(mUsedRows.size(), 0);
+    }
+    for (qsizetype i = 0; i < mUsedRows.size(); ++i) {
+        mask[i] |= mUsedRows[i];
+    }
 }
 
-int MonthCell::firstFreeSpace()
+int MonthCell::firstFreeRow(const RowMask &mask)
 {
-    int i = 0;
-    while (true) {
-        if (mHeightHash[i] == nullptr) {
-            return i;
+    for (qsizetype i = 0; i < mask.size(); ++i) {
+        if (mask[i] != ~quint64(0)) {
+            return static_cast<int>(i * 64 + qCountTrailingZeroBits(~mask[i]));
         }
-        i++;
     }
+    return static_cast<int>(mask.size() * 64);
+}
+
+int MonthCell::firstFreeSpace() const
+{
+    return firstFreeRow(mUsedRows);
 }
 
 //-------------------------------------------------------------
@@ -252,32 +283,43 @@ void MonthGraphicsItem::paint(QPainter *p, const QStyleOptionGraphicsItem *, QWi
         alignFlag |= Qt::AlignHCenter;
     }
 
-    QString text = mMonthItem->text();
-    p->setFont(mMonthItem->monthScene()->monthView()->preferences()->monthViewFont());
+    const QString &text = mMonthItem->cachedText();
+    const PrefsPtr prefs = scene->monthView()->preferences();
+    p->setFont(prefs->monthViewFont());
 
     // Every item should set its own LayoutDirection, or eliding fails miserably
     p->setLayoutDirection(text.isRightToLeft() ? Qt::RightToLeft : Qt::LeftToRight);
 
     QRect textRect = QRect(textMargin, 0, static_cast<int>(boundingRect().width() - 2 * textMargin), scene->itemHeight());
 
-    if (mMonthItem->monthScene()->monthView()->preferences()->enableMonthItemIcons()) {
-        const QList<QPixmap> icons = mMonthItem->icons();
-        int iconWidths = 0;
-
-        for (const QPixmap &icon : icons) {
-            iconWidths += icon.width();
-        }
-
-        if (!icons.isEmpty()) {
-            // add some margin between the icons and the text
-            iconWidths += textMargin / 2;
-        }
-
-        int textWidth = p->fontMetrics().size(0, text).width();
-        if (textWidth + iconWidths > textRect.width()) {
-            textWidth = textRect.width() - iconWidths;
-            text = p->fontMetrics().elidedText(text, Qt::ElideRight, textWidth);
+    const bool withIcons = prefs->enableMonthItemIcons();
+    const int layoutWidth = textRect.width();
+    const bool layoutValid = mLayoutWidth == layoutWidth && mLayoutWithIcons == withIcons;
+
+    if (withIcons) {
+        const QList<QPixmap> &icons = mMonthItem->cachedIcons();
+
+        if (!layoutValid) {
+            mIconWidths = 0;
+            for (const QPixmap &icon : icons) {
+                mIconWidths += icon.width();
+            }
+
+            if (!icons.isEmpty()) {
+                // add some margin between the icons and the text
+                mIconWidths += textMargin / 2;
+            }
+
+            mTextWidth = p->fontMetrics().size(0, text).width();
+            if (mTextWidth + mIconWidths > textRect.width()) {
+                mTextWidth = textRect.width() - mIconWidths;
+                mElidedText = p->fontMetrics().elidedText(text, Qt::ElideRight, mTextWidth);
+            } else {
+                mElidedText = text;
+            }
         }
+        const int iconWidths = mIconWidths;
+        const int textWidth = mTextWidth;
 
         int curXPos = textRect.left();
         if (alignFlag & Qt::AlignRight) {
@@ -293,16 +335,21 @@ void MonthGraphicsItem::paint(QPainter *p, const QStyleOptionGraphicsItem *, QWi
 
         const int iconHeightMax = 16; // we always use 16x16 icons
         int const pixYPos = icons.isEmpty() ? 0 : (textRect.height() - iconHeightMax) / 2;
-        for (const QPixmap &icon : std::as_const(icons)) {
+        for (const QPixmap &icon : icons) {
             p->drawPixmap(curXPos, pixYPos, icon);
             curXPos += icon.width();
         }
 
-        p->drawText(textRect, alignFlag | Qt::AlignVCenter, text);
+        p->drawText(textRect, alignFlag | Qt::AlignVCenter, mElidedText);
     } else {
-        text = p->fontMetrics().elidedText(text, Qt::ElideRight, textRect.width());
-        p->drawText(textRect, alignFlag, text);
+        if (!layoutValid) {
+            mElidedText = p->fontMetrics().elidedText(text, Qt::ElideRight, textRect.width());
+        }
+        p->drawText(textRect, alignFlag, mElidedText);
     }
+
+    mLayoutWidth = layoutWidth;
+    mLayoutWithIcons = withIcons;
 }
 
 void MonthGraphicsItem::setStartDate(QDate date)
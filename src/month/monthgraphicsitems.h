@@ -7,8 +7,11 @@
 
 #pragma once
 
+#include "eventviews_private_export.h"
+
 #include <QDate>
 #include <QGraphicsItem>
+#include <QVarLengthArray>
 
 namespace EventViews
 {
@@ -46,22 +49,38 @@ private:
 /**
  * Keeps information about a month cell.
  */
-class MonthCell
+class EVENTVIEWS_TESTS_EXPORT MonthCell
 {
 public:
+    /**
+      Occupancy of the item rows of a cell, one bit per row (vertical position).
+    */
+    using RowMask = QVarLengthArray<quint64, 2>;
+
     MonthCell(int id, QDate date, QGraphicsScene *scene);
     ~MonthCell();
 
     /**
-      This is used to get the height of the minimum height (vertical position)
-      in the month cells.
+      Reuses the cell for @p date at @p id, with no row used.
     */
-    QList<MonthItem *> mMonthItemList;
+    void reset(int id, QDate date);
+
+    [[nodiscard]] int firstFreeSpace() const;
 
-    QHash<int, MonthItem *> mHeightHash;
+    /**
+      Marks the row @p height as used by an item.
+    */
+    void addMonthItem(int height);
 
-    [[nodiscard]] int firstFreeSpace();
-    void addMonthItem(MonthItem *manager, int height);
+    /**
+      ORs the rows used in this cell into @p mask.
+    */
+    void collectUsedRows(RowMask &mask) const;
+
+    /**
+      Returns the first row which is not set in @p mask.
+    */
+    [[nodiscard]] static int firstFreeRow(const RowMask &mask);
 
     [[nodiscard]] int id() const
     {
@@ -85,7 +104,7 @@ public:
 
     static int topMargin();
     // returns true if the cell contains events below the height @p height
-    bool hasEventBelow(int height);
+    [[nodiscard]] bool hasEventBelow(int height) const;
 
     // TODO : move this to a new GUI class (monthcell could be GraphicsItems)
     ScrollIndicator *upArrow() const
@@ -102,6 +121,8 @@ private:
     int mId;
     QDate mDate;
 
+    RowMask mUsedRows;
+
     QGraphicsScene *mScene = nullptr;
 
     ScrollIndicator *mUpArrow = nullptr;
@@ -191,6 +212,14 @@ public:
 
     [[nodiscard]] QString getToolTip() const;
 
+    /**
+      Drops the cached text layout, so it is recomputed on the next paint.
+    */
+    void invalidateLayout()
+    {
+        mLayoutWidth = -1;
+    }
+
 private:
     // Shape of the item, see shape()
     [[nodiscard]] QPainterPath widgetPath(bool border) const;
@@ -203,5 +232,13 @@ private:
 
     // The current item is part of a MonthItem
     MonthItem *mMonthItem = nullptr;
+
+    // Text layout computed by paint(), valid as long as the width available
+    // for the text and the icon setting don't change.
+    QString mElidedText;
+    int mLayoutWidth = -1;
+    int mTextWidth = 0;
+    int mIconWidths = 0;
+    bool mLayoutWithIcons = false;
 };
 }
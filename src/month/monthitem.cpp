@@ -169,6 +169,18 @@ void MonthItem::moveTo(QDate date)
 
 void MonthItem::updateGeometry()
 {
+    // Graphics items only exist while the item's row is in view. The moved
+    // or resized item keeps them, they receive the mouse events.
+    if (!isMoving() && !isResizing()) {
+        if (!mMonthScene->isRowVisible(mPosition)) {
+            deleteAll();
+            return;
+        }
+        if (mMonthGraphicsItemList.isEmpty()) {
+            updateMonthGraphicsItems();
+        }
+    }
+
     for (MonthGraphicsItem *item : std::as_const(mMonthGraphicsItemList)) {
         item->updateGeometry();
     }
@@ -214,66 +226,65 @@ int MonthItem::daySpan() const
     return 0;
 }
 
-bool MonthItem::greaterThan(const MonthItem *e1, const MonthItem *e2)
+MonthItemSortKey::MonthItemSortKey(QDate startDate, int daySpan, bool allDay, bool holiday, QTime startTime, const QString &uid)
+    : mStartTime(startTime.isValid() ? startTime.msecsSinceStartOfDay() : -1)
+    , mUid(uid)
 {
-    const int leftDaySpan = e1->daySpan();
-    const int rightDaySpan = e2->daySpan();
-    if (leftDaySpan == rightDaySpan) {
-        const QDate leftStartDate = e1->startDate();
-        const QDate rightStartDate = e2->startDate();
-        if (!leftStartDate.isValid() || !rightStartDate.isValid()) {
-            return false;
-        }
-        if (leftStartDate == rightStartDate) {
-            if (e1->allDay() && !e2->allDay()) {
-                return true;
-            }
-            if (!e1->allDay() && e2->allDay()) {
-                return false;
-            }
-            return e1->greaterThanFallback(e2);
-        } else {
-            return leftStartDate > rightStartDate;
-        }
-    }
-    return leftDaySpan > rightDaySpan;
+    // 21 bits for the span, biased so that negative spans still sort first,
+    // 31 bits for the start day and one bit for each flag.
+    const quint64 span = static_cast<quint64>(qBound(0, daySpan + (1 << 20), (1 << 21) - 1));
+    const quint64 startDay = startDate.isValid() ? static_cast<quint64>(qBound<qint64>(0, startDate.toJulianDay(), (qint64(1) << 31) - 1)) : 0;
+    mPrimary = (span << 33) | (startDay << 2) | (quint64(allDay) << 1) | quint64(holiday);
 }
 
-bool MonthItem::greaterThanFallback(const MonthItem *other) const
+bool MonthItem::greaterThan(const MonthItem *e1, const MonthItem *e2)
 {
-    const auto h = qobject_cast<const HolidayMonthItem *>(other);
+    return e1->sortKey().greaterThan(e2->sortKey());
+}
 
-    // If "other" is a holiday, display it first.
-    return !h;
+MonthItemSortKey MonthItem::sortKey() const
+{
+    return {startDate(), daySpan(), allDay(), false};
 }
 
 void MonthItem::updatePosition()
 {
-    if (!startDate().isValid() || !endDate().isValid()) {
+    const QDate start = startDate();
+    const QDate end = endDate();
+    if (!start.isValid() || !end.isValid()) {
         return;
     }
 
-    int firstFreeSpace = 0;
-    for (QDate d = startDate(); d <= endDate(); d = d.addDays(1)) {
-        MonthCell *cell = mMonthScene->mMonthCellMap.value(d);
-        if (!cell) {
-            continue; // cell can be null if the item begins outside the month
-        }
-        int const firstFreeSpaceTmp = cell->firstFreeSpace();
-        if (firstFreeSpaceTmp > firstFreeSpace) {
-            firstFreeSpace = firstFreeSpaceTmp;
-        }
+    mPosition = mMonthScene->allocateRow(start, end);
+}
+
+const QString &MonthItem::cachedText() const
+{
+    if (!mTextCached) {
+        mCachedText = text();
+        mTextCached = true;
     }
+    return mCachedText;
+}
 
-    for (QDate d = startDate(); d <= endDate(); d = d.addDays(1)) {
-        MonthCell *cell = mMonthScene->mMonthCellMap.value(d);
-        if (!cell) {
-            continue;
-        }
-        cell->addMonthItem(this, firstFreeSpace);
+const QList<QPixmap> &MonthItem::cachedIcons() const
+{
+    if (!mIconsCached) {
+        mCachedIcons = icons();
+        mIconsCached = true;
     }
+    return mCachedIcons;
+}
 
-    mPosition = firstFreeSpace;
+void MonthItem::invalidateCache()
+{
+    mTextCached = false;
+    mIconsCached = false;
+    mCachedText.clear();
+    mCachedIcons.clear();
+    for (MonthGraphicsItem *item : std::as_const(mMonthGraphicsItemList)) {
+        item->invalidateLayout();
+    }
 }
 
 QList<MonthGraphicsItem *> &EventViews::MonthItem::monthGraphicsItems()
@@ -315,63 +326,67 @@ IncidenceMonthItem::IncidenceMonthItem(MonthScene *monthScene,
 
     connect(monthScene, &MonthScene::incidenceSelected, this, &IncidenceMonthItem::updateSelection);
 
-    // first set to 0, because it's used in startDate()
-    mRecurDayOffset = 0;
-    const auto incidenceStart = mIncidence->dtStart().toLocalTime().date();
-    if ((mIncidence->recurs() || mIncidence->recurrenceId().isValid()) && incidenceStart.isValid() && recurStartDate.isValid()) {
-        mRecurDayOffset = incidenceStart.daysTo(recurStartDate);
-    }
+    mRecurDayOffset = recurDayOffset(mIncidence, recurStartDate);
 }
 
 IncidenceMonthItem::~IncidenceMonthItem() = default;
 
-bool IncidenceMonthItem::greaterThanFallback(const MonthItem *other) const
+MonthItemSortKey IncidenceMonthItem::sortKey() const
 {
-    const auto o = qobject_cast<const IncidenceMonthItem *>(other);
-    if (!o) {
-        return MonthItem::greaterThanFallback(other);
-    }
+    return occurrenceSortKey(mIncidence, startDate(), endDate());
+}
 
-    if (allDay() != o->allDay()) {
-        return allDay();
-    }
-    const KCalendarCore::Incidence::Ptr otherIncidence = o->mIncidence;
+MonthItemSortKey IncidenceMonthItem::occurrenceSortKey(const KCalendarCore::Incidence::Ptr &incidence, QDate startDate, QDate endDate)
+{
+    return {startDate, startDate.daysTo(endDate), incidence->allDay(), false, incidence->dtStart().time(), incidence->uid()};
+}
 
-    if (mIncidence->dtStart().time() != otherIncidence->dtStart().time()) {
-        return mIncidence->dtStart().time() < otherIncidence->dtStart().time();
+int IncidenceMonthItem::recurDayOffset(const KCalendarCore::Incidence::Ptr &incidence, QDate recurStartDate)
+{
+    const auto incidenceStart = incidence->dtStart().toLocalTime().date();
+    if ((incidence->recurs() || incidence->recurrenceId().isValid()) && incidenceStart.isValid() && recurStartDate.isValid()) {
+        return incidenceStart.daysTo(recurStartDate);
     }
-
-    // as a last resort, compare uids
-    return mIncidence->uid() < otherIncidence->uid();
+    return 0;
 }
 
-QDate IncidenceMonthItem::realStartDate() const
+QDate IncidenceMonthItem::displayStartDate(const KCalendarCore::Incidence::Ptr &incidence, int recurDayOffset)
 {
-    if (!mIncidence) {
+    if (!incidence) {
         return {};
     }
 
-    const QDateTime dt = mIncidence->dateTime(Incidence::RoleDisplayStart);
+    const QDateTime dt = incidence->dateTime(Incidence::RoleDisplayStart);
     const QDate start = dt.toLocalTime().date();
 
-    return start.addDays(mRecurDayOffset);
+    return start.addDays(recurDayOffset);
 }
 
-QDate IncidenceMonthItem::realEndDate() const
+QDate IncidenceMonthItem::displayEndDate(const KCalendarCore::Incidence::Ptr &incidence, int recurDayOffset)
 {
-    if (!mIncidence) {
+    if (!incidence) {
         return {};
     }
 
-    QDateTime dt = mIncidence->dateTime(KCalendarCore::Incidence::RoleDisplayEnd);
-    if (!mIncidence->allDay() && dt > mIncidence->dateTime(KCalendarCore::Incidence::RoleDisplayStart)) {
+    QDateTime dt = incidence->dateTime(KCalendarCore::Incidence::RoleDisplayEnd);
+    if (!incidence->allDay() && dt > incidence->dateTime(KCalendarCore::Incidence::RoleDisplayStart)) {
         // If dt's time portion is 00:00:00, the incidence ends on the previous day
         // unless it also starts at 00:00:00 (a duration of 0).
         dt = dt.addMSecs(-1);
     }
     const QDate end = dt.toLocalTime().date();
 
-    return end.addDays(mRecurDayOffset);
+    return end.addDays(recurDayOffset);
+}
+
+QDate IncidenceMonthItem::realStartDate() const
+{
+    return displayStartDate(mIncidence, mRecurDayOffset);
+}
+
+QDate IncidenceMonthItem::realEndDate() const
+{
+    return displayEndDate(mIncidence, mRecurDayOffset);
 }
 
 bool IncidenceMonthItem::allDay() const
@@ -716,11 +731,10 @@ HolidayMonthItem::HolidayMonthItem(MonthScene *monthScene, QDate startDate, QDat
 
 HolidayMonthItem::~HolidayMonthItem() = default;
 
-bool HolidayMonthItem::greaterThanFallback(const MonthItem *other) const
+MonthItemSortKey HolidayMonthItem::sortKey() const
 {
-    const auto o = qobject_cast<const HolidayMonthItem *>(other);
     // always put holidays on top
-    return !o;
+    return {startDate(), daySpan(), allDay(), true};
 }
 
 void HolidayMonthItem::finalizeMove(const QDate &newStartDate)
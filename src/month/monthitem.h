@@ -20,6 +20,40 @@ namespace EventViews
 class MonthGraphicsItem;
 class MonthScene;
 
+/*!
+ * Packed key used to sort the items of the month view, see
+ * MonthItem::greaterThan(). It is computed once per item, so sorting
+ * doesn't go through the incidences.
+ */
+class MonthItemSortKey
+{
+public:
+    MonthItemSortKey() = default;
+
+    /*!
+      \a startTime and \a uid order incidences which are equal otherwise.
+    */
+    MonthItemSortKey(QDate startDate, int daySpan, bool allDay, bool holiday, QTime startTime = QTime(), const QString &uid = QString());
+
+    [[nodiscard]] bool greaterThan(const MonthItemSortKey &other) const
+    {
+        if (mPrimary != other.mPrimary) {
+            return mPrimary > other.mPrimary;
+        }
+        if (mStartTime != other.mStartTime) {
+            return mStartTime < other.mStartTime;
+        }
+        return mUid < other.mUid;
+    }
+
+private:
+    // day span, start day, all day and holiday flags, from the most
+    // significant bits to the least significant ones
+    quint64 mPrimary = 0;
+    int mStartTime = -1;
+    QString mUid;
+};
+
 /*!
  * A month item manages different MonthGraphicsItems.
  */
@@ -52,10 +86,9 @@ public:
     static bool greaterThan(const MonthItem *e1, const MonthItem *e2);
 
     /*!
-      Compare this event with a second one, if the former function is not
-      able to sort them.
+      Returns the key greaterThan() compares.
     */
-    virtual bool greaterThanFallback(const MonthItem *other) const;
+    [[nodiscard]] virtual MonthItemSortKey sortKey() const;
 
     /*!
       The start date of the incidence, generally realStartDate. But it
@@ -91,9 +124,21 @@ public:
 
     /*!
       Updates geometry of all MonthGraphicsItems.
+
+      The MonthGraphicsItems are deleted when the position of this item is
+      scrolled out of view, and rebuilt when it comes back.
     */
     void updateGeometry();
 
+    /*!
+      Sets the position of the item, when it was computed by the scene
+      instead of updatePosition().
+    */
+    void setPosition(int position)
+    {
+        mPosition = position;
+    }
+
     /*!
       Find the lowest possible position for this item.
 
@@ -243,6 +288,23 @@ public:
     */
     virtual QList<QPixmap> icons() const = 0;
 
+    /*!
+      Returns text(), computed on first use and kept until invalidateCache().
+    */
+    [[nodiscard]] const QString &cachedText() const;
+
+    /*!
+      Returns icons(), computed on first use and kept until invalidateCache().
+    */
+    [[nodiscard]] const QList<QPixmap> &cachedIcons() const;
+
+    /*!
+      Drops the cached text and icons, and the text layout of all
+      MonthGraphicsItems. Call this when the incidence or the preferences
+      used to paint it change.
+    */
+    void invalidateCache();
+
     QList<MonthGraphicsItem *> &monthGraphicsItems();
 
 protected:
@@ -273,6 +335,12 @@ private:
     int mOverrideDaySpan = 0;
 
     int mPosition = 0;
+
+    // See cachedText() and cachedIcons()
+    mutable QString mCachedText;
+    mutable QList<QPixmap> mCachedIcons;
+    mutable bool mTextCached = false;
+    mutable bool mIconsCached = false;
 };
 
 class EVENTVIEWS_EXPORT IncidenceMonthItem : public MonthItem
@@ -307,7 +375,31 @@ public:
 
     /*!
      */
-    bool greaterThanFallback(const MonthItem *other) const override;
+    [[nodiscard]] MonthItemSortKey sortKey() const override;
+
+    /*!
+      Returns the sort key of the occurrence of \a incidence displayed from
+      \a startDate to \a endDate.
+    */
+    [[nodiscard]] static MonthItemSortKey occurrenceSortKey(const KCalendarCore::Incidence::Ptr &incidence, QDate startDate, QDate endDate);
+
+    /*!
+      Returns the offset in days of the occurrence starting on
+      \a recurStartDate from the start of \a incidence.
+    */
+    [[nodiscard]] static int recurDayOffset(const KCalendarCore::Incidence::Ptr &incidence, QDate recurStartDate);
+
+    /*!
+      Returns the first day on which the occurrence of \a incidence
+      shifted by \a recurDayOffset days is displayed.
+    */
+    [[nodiscard]] static QDate displayStartDate(const KCalendarCore::Incidence::Ptr &incidence, int recurDayOffset);
+
+    /*!
+      Returns the last day on which the occurrence of \a incidence
+      shifted by \a recurDayOffset days is displayed.
+    */
+    [[nodiscard]] static QDate displayEndDate(const KCalendarCore::Incidence::Ptr &incidence, int recurDayOffset);
 
     /*!
      */
@@ -394,7 +486,7 @@ public:
 
     /*!
      */
-    bool greaterThanFallback(const MonthItem *other) const override;
+    [[nodiscard]] MonthItemSortKey sortKey() const override;
 
     /*!
      */
@@ -50,6 +50,7 @@ MonthScene::~MonthScene()
 {
     qDeleteAll(mMonthCellMap);
     qDeleteAll(mManagerList);
+    qDeleteAll(mRemovedManagerList);
 }
 
 MonthCell *MonthScene::selectedCell() const
@@ -87,6 +88,11 @@ int MonthScene::maxRowCount()
     return (rowHeight() - MonthCell::topMargin()) / itemHeightIncludingSpacing();
 }
 
+bool MonthScene::isRowVisible(int row)
+{
+    return row >= startHeight() && row - startHeight() < maxRowCount();
+}
+
 /* cppcheck-suppress functionStatic */
 int MonthScene::itemHeightIncludingSpacing()
 {
@@ -113,11 +119,46 @@ MonthCell *MonthScene::firstCellForMonthItem(MonthItem *manager)
 
 void MonthScene::updateGeometry()
 {
+    // Scrolling or resizing can reveal rows whose items don't exist yet.
+    // Their geometry is computed with the others below.
+    createMissingVisibleMonthItems();
+
     for (MonthItem *manager : std::as_const(mManagerList)) {
         manager->updateGeometry();
     }
 }
 
+int MonthScene::allocateRow(QDate startDate, QDate endDate)
+{
+    // The cells are keyed by consecutive dates, so the ones covered by the
+    // item are a contiguous range of the map. Cells can be missing if the
+    // item begins or ends outside the month.
+    const auto &cellMap = mMonthCellMap;
+    const auto begin = cellMap.lowerBound(startDate);
+    const auto last = cellMap.upperBound(endDate);
+
+    // An item keeps the same row in every cell it crosses, so the first
+    // row free in all of them is the first zero of their OR-ed occupancy.
+    MonthCell::RowMask usedRows;
+    for (auto it = begin; it != last; ++it) {
+        it.value()->collectUsedRows(usedRows);
+    }
+    const int row = MonthCell::firstFreeRow(usedRows);
+
+    for (auto it = begin; it != last; ++it) {
+        it.value()->addMonthItem(row);
+    }
+
+    return row;
+}
+
+void MonthScene::invalidateItemCaches()
+{
+    for (MonthItem *manager : std::as_const(mManagerList)) {
+        manager->invalidateCache();
+    }
+}
+
 int MonthScene::availableWidth() const
 {
     return static_cast<int>(sceneRect().width());
@@ -237,15 +278,8 @@ void MonthGraphicsView::drawBackground(QPainter *p, const QRectF &rect)
     const QList<QDate> workDays = CalendarSupport::workDays(mMonthView->actualStartDateTime().date(), mMonthView->actualEndDateTime().date());
     QRect todayRect;
     QRect selectedRect;
-    QColor holidayBg;
-    QColor workdayBg;
-    if (mMonthView->preferences()->useSystemColor()) {
-        workdayBg = palette().color(QPalette::Base);
-        holidayBg = palette().color(QPalette::AlternateBase);
-    } else {
-        workdayBg = mMonthView->preferences()->monthGridWorkHoursBackgroundColor();
-        holidayBg = mMonthView->preferences()->monthGridBackgroundColor();
-    }
+    const QColor holidayBg = cellBackground(prefs, palette(), false);
+    const QColor workdayBg = cellBackground(prefs, palette(), true);
 
     for (QDate d = start; d <= end; d = d.addDays(1)) {
         const MonthCell *const cell = mScene->mMonthCellMap.value(d);
@@ -265,7 +299,7 @@ void MonthGraphicsView::drawBackground(QPainter *p, const QRectF &rect)
         }
 
         // Draw cell
-        p->setPen(mMonthView->preferences()->monthGridBackgroundColor().darker(150));
+        p->setPen(gridColor(prefs));
         p->setBrush(workDays.contains(d) ? workdayBg : holidayBg);
         p->drawRect(cellRect);
         const QStringList holidayCats = CalendarSupport::KCalPrefs::instance()->holidayCategories();
@@ -288,12 +322,7 @@ void MonthGraphicsView::drawBackground(QPainter *p, const QRectF &rect)
         p->drawRect(todayRect);
     }
     if (!selectedRect.isNull()) {
-        const KColorScheme scheme(QPalette::Normal, KColorScheme::ColorSet::Selection);
-        auto color = scheme.background(KColorScheme::BackgroundRole::NormalBackground).color();
-        p->setPen(color);
-        color.setAlpha(EventViews::BUSY_BACKGROUND_ALPHA);
-        p->setBrush(color);
-        p->drawRect(selectedRect);
+        drawSelection(p, selectedRect);
     }
 
     /*
@@ -386,6 +415,12 @@ void MonthScene::resetAll()
 
     qDeleteAll(mManagerList);
     mManagerList.clear();
+    qDeleteAll(mRemovedManagerList);
+    mRemovedManagerList.clear();
+    mOccurrences.clear();
+    mOccurrencesByUid.clear();
+    mOccurrencesByAkonadiItemId.clear();
+    mOccurrencesByRow.clear();
 
     mSelectedItem = nullptr;
     mActionItem = nullptr;
@@ -475,9 +510,7 @@ void MonthScene::scrollCellsDown()
     int const newHeight = startHeight() + 1;
     setStartHeight(newHeight);
 
-    for (MonthItem *manager : std::as_const(mManagerList)) {
-        manager->updateGeometry();
-    }
+    updateGeometry();
 
     invalidate(QRectF(), BackgroundLayer);
 }
@@ -487,9 +520,7 @@ void MonthScene::scrollCellsUp()
     int const newHeight = startHeight() - 1;
     setStartHeight(newHeight);
 
-    for (MonthItem *manager : std::as_const(mManagerList)) {
-        manager->updateGeometry();
-    }
+    updateGeometry();
 
     invalidate(QRectF(), BackgroundLayer);
 }
@@ -764,26 +795,243 @@ void MonthScene::selectItem(MonthItem *item)
 
 void MonthScene::removeIncidence(const QString &uid)
 {
-    for (MonthItem *manager : std::as_const(mManagerList)) {
-        auto imi = qobject_cast<IncidenceMonthItem *>(manager);
-        if (!imi) {
+    const auto indexes = mOccurrencesByUid.values(uid);
+    for (qsizetype index : indexes) {
+        MonthOccurrence &occurrence = mOccurrences[index];
+        occurrence.flags |= MonthOccurrence::Removed;
+        if (occurrence.monthItem) {
+            // Stop updating the item, so its graphics items are not rebuilt
+            occurrence.monthItem->deleteAll();
+            mManagerList.removeOne(occurrence.monthItem);
+            mRemovedManagerList.append(occurrence.monthItem);
+        }
+    }
+}
+
+void MonthScene::addIncidenceOccurrence(const Akonadi::CollectionCalendar::Ptr &calendar,
+                                        const Akonadi::Item &item,
+                                        const KCalendarCore::Incidence::Ptr &incidence,
+                                        QDate recurStartDate)
+{
+    const int recurDayOffset = IncidenceMonthItem::recurDayOffset(incidence, recurStartDate);
+
+    MonthOccurrence occurrence;
+    occurrence.startDate = IncidenceMonthItem::displayStartDate(incidence, recurDayOffset);
+    occurrence.endDate = IncidenceMonthItem::displayEndDate(incidence, recurDayOffset);
+    occurrence.recurStartDate = recurStartDate;
+    occurrence.sortKey = IncidenceMonthItem::occurrenceSortKey(incidence, occurrence.startDate, occurrence.endDate);
+    if (incidence->allDay()) {
+        occurrence.flags |= MonthOccurrence::AllDay;
+    }
+    occurrence.calendar = calendar;
+    occurrence.item = item;
+    occurrence.incidence = incidence;
+    mOccurrences.push_back(std::move(occurrence));
+}
+
+void MonthScene::addHolidayOccurrence(QDate startDate, QDate endDate, const QString &name)
+{
+    MonthOccurrence occurrence;
+    occurrence.startDate = startDate;
+    occurrence.endDate = endDate;
+    occurrence.sortKey = MonthItemSortKey(startDate, startDate.daysTo(endDate), true, true);
+    occurrence.flags = MonthOccurrence::AllDay | MonthOccurrence::Holiday;
+    occurrence.holidayName = name;
+    mOccurrences.push_back(std::move(occurrence));
+}
+
+void MonthScene::layoutOccurrences()
+{
+    std::sort(mOccurrences.begin(), mOccurrences.end(), [](const MonthOccurrence &o1, const MonthOccurrence &o2) {
+        return o1.sortKey.greaterThan(o2.sortKey);
+    });
+
+    mOccurrencesByUid.reserve(mOccurrences.size());
+    mOccurrencesByAkonadiItemId.reserve(mOccurrences.size());
+    for (qsizetype i = 0; i < mOccurrences.size(); ++i) {
+        MonthOccurrence &occurrence = mOccurrences[i];
+        if (occurrence.startDate.isValid() && occurrence.endDate.isValid()) {
+            occurrence.position = allocateRow(occurrence.startDate, occurrence.endDate);
+            if (occurrence.position >= mOccurrencesByRow.size()) {
+                mOccurrencesByRow.resize(occurrence.position + 1);
+            }
+            mOccurrencesByRow[occurrence.position].append(i);
+        }
+        if (occurrence.monthItem) {
+            // Kept by scrollWeeks()
+            occurrence.monthItem->setPosition(occurrence.position);
+        }
+        if (occurrence.incidence) {
+            mOccurrencesByUid.insert(occurrence.incidence->uid(), i);
+            mOccurrencesByAkonadiItemId.insert(occurrence.item.id(), i);
+        }
+    }
+}
+
+void MonthScene::scrollWeeks(QDate startDate, QDate keptFrom, QDate keptTo)
+{
+    const int cellCount = static_cast<int>(mMonthCellMap.size());
+
+    QList<MonthCell *> spareCells;
+    for (auto it = mMonthCellMap.begin(); it != mMonthCellMap.end();) {
+        if (it.key() < keptFrom || it.key() > keptTo) {
+            spareCells.append(it.value());
+            it = mMonthCellMap.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    QDate date = startDate;
+    for (int id = 0; id < cellCount; ++id, date = date.addDays(1)) {
+        MonthCell *cell = mMonthCellMap.value(date);
+        if (!cell) {
+            cell = spareCells.takeLast();
+            mMonthCellMap.insert(date, cell);
+        }
+        // The rows are allocated again by layoutOccurrences()
+        cell->reset(id, date);
+    }
+    Q_ASSERT(spareCells.isEmpty());
+
+    QList<MonthOccurrence> keptOccurrences;
+    keptOccurrences.reserve(mOccurrences.size());
+    for (MonthOccurrence &occurrence : mOccurrences) {
+        if (occurrence.flags & MonthOccurrence::Removed) {
+            // Its item is already in mRemovedManagerList
             continue;
         }
 
-        KCalendarCore::Incidence::Ptr const incidence = imi->incidence();
-        if (!incidence) {
+        MonthItem *manager = occurrence.monthItem;
+        if (occurrence.startDate.isValid() && occurrence.endDate.isValid() && occurrence.startDate <= keptTo && occurrence.endDate >= keptFrom) {
+            if (manager && (occurrence.startDate < keptFrom || occurrence.endDate > keptTo)) {
+                // It crosses the scrolled boundary, so one of its week
+                // parts comes or goes. The others are still right.
+                manager->deleteAll();
+            }
+            keptOccurrences.push_back(std::move(occurrence));
             continue;
         }
-        if (incidence->uid() == uid) {
-            const auto lst = imi->monthGraphicsItems();
-            for (MonthGraphicsItem *gitem : lst) {
-                removeItem(gitem);
+
+        if (manager) {
+            mManagerList.removeOne(manager);
+            if (manager == mSelectedItem) {
+                mSelectedItem = nullptr;
+            }
+            if (manager == mClickedItem || manager == mActionItem) {
+                // Still referenced by the user interaction
+                manager->deleteAll();
+                mRemovedManagerList.append(manager);
+            } else {
+                delete manager;
+            }
+        }
+    }
+    mOccurrences = std::move(keptOccurrences);
+    mOccurrencesByUid.clear();
+    mOccurrencesByAkonadiItemId.clear();
+    mOccurrencesByRow.clear();
+}
+
+MonthItem *MonthScene::monthItemForOccurrence(qsizetype index)
+{
+    MonthItem *manager = mOccurrences.at(index).monthItem;
+    if (!manager) {
+        manager = createMonthItem(index);
+        manager->updateGeometry();
+    }
+    return manager;
+}
+
+MonthItem *MonthScene::createMonthItem(qsizetype index)
+{
+    MonthOccurrence &occurrence = mOccurrences[index];
+    Q_ASSERT(!occurrence.monthItem);
+
+    MonthItem *manager = nullptr;
+    if (occurrence.isHoliday()) {
+        manager = new HolidayMonthItem(this, occurrence.startDate, occurrence.endDate, occurrence.holidayName);
+    } else {
+        manager = new IncidenceMonthItem(this, occurrence.calendar, occurrence.item, occurrence.incidence, occurrence.recurStartDate);
+    }
+    manager->setPosition(occurrence.position);
+    mManagerList.push_back(manager);
+    occurrence.monthItem = manager;
+    return manager;
+}
+
+QList<MonthItem *> MonthScene::createMissingVisibleMonthItems()
+{
+    QList<MonthItem *> created;
+
+    // Only the buckets of the rows in view are looked at, not every occurrence
+    const qsizetype firstRow = std::max(startHeight(), 0);
+    const qsizetype lastRow = std::min<qsizetype>(firstRow + maxRowCount(), mOccurrencesByRow.size());
+    for (qsizetype row = firstRow; row < lastRow; ++row) {
+        for (qsizetype index : std::as_const(mOccurrencesByRow.at(row))) {
+            const MonthOccurrence &occurrence = mOccurrences.at(index);
+            if (!occurrence.monthItem && !(occurrence.flags & MonthOccurrence::Removed)) {
+                created.append(createMonthItem(index));
             }
         }
     }
+    return created;
+}
+
+void MonthScene::createVisibleMonthItems()
+{
+    const QList<MonthItem *> created = createMissingVisibleMonthItems();
+    for (MonthItem *manager : created) {
+        manager->updateGeometry();
+    }
+}
+
+QList<IncidenceMonthItem *> MonthScene::itemsForUid(const QString &uid) const
+{
+    QList<IncidenceMonthItem *> items;
+    const auto indexes = mOccurrencesByUid.values(uid);
+    for (qsizetype index : indexes) {
+        if (auto imi = qobject_cast<IncidenceMonthItem *>(mOccurrences.at(index).monthItem)) {
+            items << imi;
+        }
+    }
+    return items;
+}
+
+qsizetype MonthScene::findOccurrence(Akonadi::Item::Id id, QDate startDate) const
+{
+    const auto indexes = mOccurrencesByAkonadiItemId.values(id);
+    for (qsizetype index : indexes) {
+        if (mOccurrences.at(index).startDate == startDate) {
+            return index;
+        }
+    }
+    return -1;
 }
 
 //----------------------------------------------------------
+QColor MonthGraphicsView::cellBackground(const PrefsPtr &prefs, const QPalette &palette, bool workDay)
+{
+    if (prefs->useSystemColor()) {
+        return palette.color(workDay ? QPalette::Base : QPalette::AlternateBase);
+    }
+    return workDay ? prefs->monthGridWorkHoursBackgroundColor() : prefs->monthGridBackgroundColor();
+}
+
+QColor MonthGraphicsView::gridColor(const PrefsPtr &prefs)
+{
+    return prefs->monthGridBackgroundColor().darker(150);
+}
+
+void MonthGraphicsView::drawSelection(QPainter *p, const QRect &rect)
+{
+    const KColorScheme scheme(QPalette::Normal, KColorScheme::ColorSet::Selection);
+    auto color = scheme.background(KColorScheme::BackgroundRole::NormalBackground).color();
+    p->setPen(color);
+    color.setAlpha(EventViews::BUSY_BACKGROUND_ALPHA);
+    p->setBrush(color);
+    p->drawRect(rect);
+}
+
 MonthGraphicsView::MonthGraphicsView(MonthView *parent)
     : QGraphicsView(parent)
     , mMonthView(parent)
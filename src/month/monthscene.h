@@ -8,15 +8,21 @@
 
 #pragma once
 
+#include "eventviews_private_export.h"
+#include "helper.h"
+#include "monthitem.h"
+
 #include <Akonadi/Collection>
 #include <Akonadi/CollectionCalendar>
 #include <Akonadi/Item>
+#include <KCalendarCore/Incidence>
 
 #include <QBasicTimer>
 #include <QDate>
 #include <QGraphicsScene>
 #include <QGraphicsView>
 #include <QMap>
+#include <QMultiHash>
 
 namespace Akonadi
 {
@@ -25,12 +31,53 @@ class IncidenceChanger;
 
 namespace EventViews
 {
+class IncidenceMonthItem;
 class MonthCell;
 class MonthItem;
 class MonthView;
 class ScrollIndicator;
 
-class MonthScene : public QGraphicsScene
+/**
+ * Compact description of one occurrence (or holiday) shown in the month view.
+ *
+ * The scene keeps one of these per occurrence in a contiguous list, sorts
+ * and places them, and only creates a MonthItem, with its graphics items,
+ * for the occurrences in the visible rows of the cells.
+ */
+struct MonthOccurrence {
+    enum Flag : quint8 {
+        AllDay = 0x01,
+        Holiday = 0x02,
+        Removed = 0x04, // the incidence was deleted, never show it
+    };
+
+    QDate startDate;
+    QDate endDate;
+    QDate recurStartDate;
+    MonthItemSortKey sortKey;
+    int position = 0;
+    quint8 flags = 0;
+
+    Akonadi::CollectionCalendar::Ptr calendar;
+    Akonadi::Item item;
+    KCalendarCore::Incidence::Ptr incidence; // null for holidays
+    QString holidayName;
+
+    // Created on demand, see MonthScene::monthItemForOccurrence()
+    MonthItem *monthItem = nullptr;
+
+    [[nodiscard]] int daySpan() const
+    {
+        return startDate.daysTo(endDate);
+    }
+
+    [[nodiscard]] bool isHoliday() const
+    {
+        return flags & Holiday;
+    }
+};
+
+class EVENTVIEWS_TESTS_EXPORT MonthScene : public QGraphicsScene
 {
     Q_OBJECT
 
@@ -100,6 +147,12 @@ public:
     void selectItem(MonthItem *);
     [[nodiscard]] int maxRowCount();
 
+    /**
+      Returns true if items on @p row are in view in the cells, given the
+      current scrolling and the number of rows that fit.
+    */
+    [[nodiscard]] bool isRowVisible(int row);
+
     MonthCell *selectedCell() const;
     MonthCell *previousCell() const;
 
@@ -119,10 +172,22 @@ public:
     [[nodiscard]] QDate firstDateOnRow(int row) const;
 
     /**
-      Calls updateGeometry() on each MonthItem
+      Creates the MonthItems of the rows which became visible and calls
+      updateGeometry() on each MonthItem
     */
     void updateGeometry();
 
+    /**
+      Finds the first row free in all the cells from @p startDate to
+      @p endDate, marks it as used in them and returns it.
+    */
+    int allocateRow(QDate startDate, QDate endDate);
+
+    /**
+      Calls invalidateCache() on each MonthItem
+    */
+    void invalidateItemCaches();
+
     /**
       Returns the first height. Used for scrolling
 
@@ -199,6 +264,67 @@ public:
     */
     void removeIncidence(const QString &uid);
 
+    /**
+      Adds an occurrence of @p incidence starting on @p recurStartDate.
+      Call layoutOccurrences() once all occurrences are added.
+    */
+    void addIncidenceOccurrence(const Akonadi::CollectionCalendar::Ptr &calendar,
+                                const Akonadi::Item &item,
+                                const KCalendarCore::Incidence::Ptr &incidence,
+                                QDate recurStartDate);
+
+    /**
+      Adds a holiday. Call layoutOccurrences() once all occurrences are added.
+    */
+    void addHolidayOccurrence(QDate startDate, QDate endDate, const QString &name);
+
+    /**
+      Sorts the occurrences, assigns each one a row in the cells it crosses
+      and indexes them by UID and Akonadi item id.
+    */
+    void layoutOccurrences();
+
+    /**
+      Moves the cells to begin on @p startDate, a whole number of weeks away
+      from the first cell. The cells of the weeks scrolled out are reused for
+      the exposed ones.
+
+      Only the occurrences crossing the kept dates, from @p keptFrom to
+      @p keptTo, stay, with their MonthItems. Add the occurrences of the
+      exposed weeks and call layoutOccurrences() afterwards.
+    */
+    void scrollWeeks(QDate startDate, QDate keptFrom, QDate keptTo);
+
+    /**
+      Returns the MonthItem of the occurrence at @p index in mOccurrences,
+      creating it and its graphics items if needed.
+    */
+    MonthItem *monthItemForOccurrence(qsizetype index);
+
+    /**
+      Creates the MonthItems of the occurrences in the visible rows.
+    */
+    void createVisibleMonthItems();
+
+    /**
+      Returns the items showing occurrences of the incidence with @p uid.
+    */
+    [[nodiscard]] QList<IncidenceMonthItem *> itemsForUid(const QString &uid) const;
+
+    /**
+      Returns the index in mOccurrences of the occurrence of the Akonadi
+      item @p id displayed from @p startDate, or -1.
+    */
+    [[nodiscard]] qsizetype findOccurrence(Akonadi::Item::Id id, QDate startDate) const;
+
+    /**
+      Returns the occurrences, in the order of layoutOccurrences().
+    */
+    [[nodiscard]] const QList<MonthOccurrence> &occurrences() const
+    {
+        return mOccurrences;
+    }
+
 Q_SIGNALS:
     void incidenceSelected(const Akonadi::Item &, const QDate &);
     void showIncidencePopupSignal(const Akonadi::CollectionCalendar::Ptr &, const Akonadi::Item &, const QDate &);
@@ -286,8 +412,32 @@ private:
     */
     bool isInMonthGrid(int x, int y) const;
 
+    /**
+      Creates the MonthItem of the occurrence at @p index in mOccurrences,
+      without computing its geometry.
+    */
+    MonthItem *createMonthItem(qsizetype index);
+
+    /**
+      Creates the missing MonthItems of the occurrences in the visible rows
+      and returns them, without computing their geometry.
+    */
+    QList<MonthItem *> createMissingVisibleMonthItems();
+
     bool mInitialized;
 
+    QList<MonthOccurrence> mOccurrences;
+
+    // Items of deleted incidences, kept alive until the next reset because
+    // they may still be referenced by an ongoing user interaction
+    QList<MonthItem *> mRemovedManagerList;
+
+    // Indexes of mOccurrences, see layoutOccurrences()
+    QMultiHash<QString, qsizetype> mOccurrencesByUid;
+    QMultiHash<Akonadi::Item::Id, qsizetype> mOccurrencesByAkonadiItemId;
+    // Indexes of mOccurrences by row, ascending within each row
+    QList<QList<qsizetype>> mOccurrencesByRow;
+
     // User interaction.
     MonthItem *mClickedItem = nullptr; // todo ini in ctor
     MonthItem *mActionItem = nullptr;
@@ -338,6 +488,23 @@ public:
     */
     void setActionCursor(MonthScene::ActionType actionType);
 
+    /**
+      Returns the background of the cells of work days, or of the other
+      days if @p workDay is false, as configured in @p prefs.
+      Shared with the year view.
+    */
+    [[nodiscard]] static QColor cellBackground(const PrefsPtr &prefs, const QPalette &palette, bool workDay);
+
+    /**
+      Returns the color of the cell borders.
+    */
+    [[nodiscard]] static QColor gridColor(const PrefsPtr &prefs);
+
+    /**
+      Highlights the selected cell @p rect.
+    */
+    static void drawSelection(QPainter *p, const QRect &rect);
+
 protected:
     void resizeEvent(QResizeEvent *) override;
 
@@ -7,10 +7,12 @@
 */
 
 #include "monthview.h"
+#include "calendargroups.h"
 #include "monthgraphicsitems.h"
 #include "monthitem.h"
 #include "monthscene.h"
 #include "prefs.h"
+#include "reloadtimer.h"
 
 #include <Akonadi/CalendarBase>
 #include <CalendarSupport/CollectionSelection>
@@ -27,6 +29,7 @@
 #include <QTimer>
 #include <QToolButton>
 #include <QWheelEvent>
+#include <QtConcurrentMap>
 
 using namespace EventViews;
 
@@ -39,15 +42,39 @@ class MonthViewPrivate : public KCalendarCore::Calendar::CalendarObserver
 public: /// Methods
     explicit MonthViewPrivate(MonthView *qq);
 
-    MonthItem *loadCalendarIncidences(const Akonadi::CollectionCalendar::Ptr &calendar, const QDateTime &startDt, const QDateTime &endDt);
+    // An occurrence found by expandOccurrences()
+    struct Occurrence {
+        KCalendarCore::Incidence::Ptr incidence;
+        QDateTime startDateTime;
+    };
+
+    // Doesn't touch the view, so it can run in a worker thread, as long as no
+    // other thread expands a calendar sharing incidences with this one
+    static QList<Occurrence> expandOccurrences(const Akonadi::CollectionCalendar::Ptr &calendar,
+                                               const QDateTime &startDt,
+                                               const QDateTime &endDt,
+                                               bool showTodos,
+                                               bool showJournals);
+    // Occurrences crossing the dates from loadedFrom to loadedTo are skipped, they are in the scene already
+    void loadCalendarIncidences(const Akonadi::CollectionCalendar::Ptr &calendar,
+                                const QList<Occurrence> &occurrences,
+                                QDate loadedFrom = QDate(),
+                                QDate loadedTo = QDate());
+    void loadOccurrences(QDate startDate, QDate endDate, QDate loadedFrom = QDate(), QDate loadedTo = QDate());
+    bool scrollLoadedWeeks();
 
     void addIncidence(const Akonadi::Item &incidence);
     void moveStartDate(int weeks, int months);
     // void setUpModels();
     void triggerDelayedReload(EventView::Change reason);
+    void scheduleReload();
 
     /// Members
-    QTimer reloadTimer;
+    ReloadTimer reloadTimer;
+    CalendarGroups calendarGroups;
+    int reloadCount = 0;
+    int scrollReloadCount = 0;
+    bool continuousScrolling = false;
     MonthScene *scene = nullptr;
     QDate selectedItemDate;
     Akonadi::Item::Id selectedItemId{-1};
@@ -78,49 +105,163 @@ MonthViewPrivate::MonthViewPrivate(MonthView *qq)
     , view(new MonthGraphicsView(qq))
 
 {
-    reloadTimer.setSingleShot(true);
     view->setScene(scene);
 }
 
-MonthItem *MonthViewPrivate::loadCalendarIncidences(const Akonadi::CollectionCalendar::Ptr &calendar, const QDateTime &startDt, const QDateTime &endDt)
+QList<MonthViewPrivate::Occurrence> MonthViewPrivate::expandOccurrences(const Akonadi::CollectionCalendar::Ptr &calendar,
+                                                                        const QDateTime &startDt,
+                                                                        const QDateTime &endDt,
+                                                                        bool showTodos,
+                                                                        bool showJournals)
 {
-    MonthItem *itemToReselect = nullptr; // NOLINT(misc-const-correctness)
-
-    const bool colorMonthBusyDays = q->preferences()->colorMonthBusyDays();
+    QList<Occurrence> occurrences;
 
     KCalendarCore::OccurrenceIterator occurIter(*calendar, startDt, endDt);
     while (occurIter.hasNext()) {
         occurIter.next();
 
         // Remove the two checks when filtering is done through a proxyModel, when using calendar search
-        if (!q->preferences()->showTodosMonthView() && occurIter.incidence()->type() == KCalendarCore::Incidence::TypeTodo) {
+        if (!showTodos && occurIter.incidence()->type() == KCalendarCore::Incidence::TypeTodo) {
             continue;
         }
-        if (!q->preferences()->showJournalsMonthView() && occurIter.incidence()->type() == KCalendarCore::Incidence::TypeJournal) {
+        if (!showJournals && occurIter.incidence()->type() == KCalendarCore::Incidence::TypeJournal) {
             continue;
         }
 
-        const bool busyDay = colorMonthBusyDays && q->makesWholeDayBusy(occurIter.incidence());
+        occurrences.append({occurIter.incidence(), occurIter.occurrenceStartDate()});
+    }
+
+    return occurrences;
+}
+
+void MonthViewPrivate::loadCalendarIncidences(const Akonadi::CollectionCalendar::Ptr &calendar,
+                                              const QList<Occurrence> &occurrences,
+                                              QDate loadedFrom,
+                                              QDate loadedTo)
+{
+    const bool colorMonthBusyDays = q->preferences()->colorMonthBusyDays();
+
+    for (const Occurrence &occurrence : occurrences) {
+        if (loadedFrom.isValid()) {
+            const int offset = IncidenceMonthItem::recurDayOffset(occurrence.incidence, occurrence.startDateTime.toLocalTime().date());
+            if (IncidenceMonthItem::displayStartDate(occurrence.incidence, offset) <= loadedTo
+                && IncidenceMonthItem::displayEndDate(occurrence.incidence, offset) >= loadedFrom) {
+                continue;
+            }
+        }
+
+        const bool busyDay = colorMonthBusyDays && q->makesWholeDayBusy(occurrence.incidence);
         if (busyDay) {
-            QStringList &list = mBusyDays[occurIter.occurrenceStartDate().date()];
-            list.append(occurIter.incidence()->uid());
+            QStringList &list = mBusyDays[occurrence.startDateTime.date()];
+            list.append(occurrence.incidence->uid());
         }
 
-        const Akonadi::Item item = calendar->item(occurIter.incidence());
+        const Akonadi::Item item = calendar->item(occurrence.incidence);
         if (!item.isValid()) {
             continue;
         }
         Q_ASSERT(item.isValid());
         Q_ASSERT(item.hasPayload());
-        MonthItem *manager = new IncidenceMonthItem(scene, calendar, item, occurIter.incidence(), occurIter.occurrenceStartDate().toLocalTime().date());
-        scene->mManagerList.push_back(manager);
-        if (selectedItemId == item.id() && manager->realStartDate() == selectedItemDate) {
-            // only select it outside the loop because we are still creating items
-            itemToReselect = manager;
+        scene->addIncidenceOccurrence(calendar, item, occurrence.incidence, occurrence.startDateTime.toLocalTime().date());
+    }
+}
+
+void MonthViewPrivate::loadOccurrences(QDate startDate, QDate endDate, QDate loadedFrom, QDate loadedTo)
+{
+    // Expanding the recurrences runs on the thread pool, and the items are
+    // created here. The worker threads only read the calendars, which can't
+    // change while the GUI thread waits for them, and the occurrences are
+    // returned by value. They do write the caches of the incidences'
+    // Recurrence, so an incidence shared by several calendars must not be
+    // expanded by two threads: such calendars are expanded by one task.
+    const auto cals = q->calendars();
+    const QDateTime startDt = startDate.startOfDay();
+    const QDateTime endDt = endDate.endOfDay();
+    const bool showTodos = q->preferences()->showTodosMonthView();
+    const bool showJournals = q->preferences()->showJournalsMonthView();
+    const auto &groups = calendarGroups.groups(cals);
+    const auto groupOccurrences = QtConcurrent::blockingMapped<QList<QList<QList<Occurrence>>>>(
+        groups,
+        [&cals, startDt, endDt, showTodos, showJournals](const QList<qsizetype> &group) {
+            QList<QList<Occurrence>> occurrences;
+            occurrences.reserve(group.size());
+            for (qsizetype index : group) {
+                occurrences.append(expandOccurrences(cals.at(index), startDt, endDt, showTodos, showJournals));
+            }
+            return occurrences;
+        });
+
+    // Load them in the calendars' order, whatever the grouping
+    QList<QList<Occurrence>> occurrences(cals.size());
+    for (qsizetype g = 0; g < groups.size(); ++g) {
+        for (qsizetype i = 0; i < groups.at(g).size(); ++i) {
+            occurrences[groups.at(g).at(i)] = groupOccurrences.at(g).at(i);
+        }
+    }
+    for (qsizetype i = 0; i < cals.size(); ++i) {
+        loadCalendarIncidences(cals.at(i), occurrences.at(i), loadedFrom, loadedTo);
+    }
+
+    // add holidays
+    if (q->preferences()->showHolidaysMonthView()) {
+        const QStringList holidayCats = CalendarSupport::KCalPrefs::instance()->holidayCategories();
+        auto const hols = q->holidays(startDate, endDate, holidayCats);
+        for (auto const &h : hols) {
+            if (loadedFrom.isValid() && h.observedStartDate() <= loadedTo && h.observedEndDate() >= loadedFrom) {
+                continue;
+            }
+            scene->addHolidayOccurrence(h.observedStartDate(), h.observedEndDate(), h.name());
+        }
+    }
+}
+
+bool MonthViewPrivate::scrollLoadedWeeks()
+{
+    const auto &cellMap = scene->mMonthCellMap;
+    if (!scene->initialized() || cellMap.isEmpty()) {
+        return false;
+    }
+
+    const QDate loadedStart = cellMap.firstKey();
+    const QDate loadedEnd = cellMap.lastKey();
+    const QDate start = q->actualStartDateTime().date();
+    const QDate end = q->actualEndDateTime().date();
+    const qint64 days = loadedStart.daysTo(start);
+    if (days == 0 && loadedEnd == end) {
+        // Same weeks, e.g. moving by a week within the month when the grid
+        // follows the months. Nothing to do.
+        return true;
+    }
+    if (!continuousScrolling || days % 7 != 0 || loadedStart.daysTo(loadedEnd) != start.daysTo(end) || qAbs(days) > start.daysTo(end)) {
+        // Nothing to keep
+        return false;
+    }
+
+    // Keep the weeks still in view, with their cells and items, and only
+    // expand the occurrences of the exposed ones
+    const QDate keptFrom = qMax(loadedStart, start);
+    const QDate keptTo = qMin(loadedEnd, end);
+    scene->scrollWeeks(start, keptFrom, keptTo);
+
+    for (auto it = mBusyDays.begin(); it != mBusyDays.end();) {
+        if (it.key() < start || it.key() > end) {
+            it = mBusyDays.erase(it);
+        } else {
+            ++it;
         }
     }
 
-    return itemToReselect;
+    if (days > 0) {
+        loadOccurrences(keptTo.addDays(1), end, keptFrom, keptTo);
+    } else {
+        loadOccurrences(start, keptFrom.addDays(-1), keptFrom, keptTo);
+    }
+
+    scene->layoutOccurrences();
+    scene->updateGeometry();
+
+    ++scrollReloadCount;
+    return true;
 }
 
 void MonthViewPrivate::addIncidence(const Akonadi::Item &incidence)
@@ -128,7 +269,7 @@ void MonthViewPrivate::addIncidence(const Akonadi::Item &incidence)
     Q_UNUSED(incidence)
     // TODO: add some more intelligence here...
     q->setChanges(q->changes() | EventView::IncidencesAdded);
-    reloadTimer.start(50);
+    scheduleReload();
 }
 
 void MonthViewPrivate::moveStartDate(int weeks, int months)
@@ -162,18 +303,27 @@ void MonthViewPrivate::moveStartDate(int weeks, int months)
 void MonthViewPrivate::triggerDelayedReload(EventView::Change reason)
 {
     q->setChanges(q->changes() | reason);
-    if (!reloadTimer.isActive()) {
-        reloadTimer.start(50);
-    }
+    scheduleReload();
+}
+
+void MonthViewPrivate::scheduleReload()
+{
+    reloadTimer.schedule();
 }
 
 void MonthViewPrivate::calendarIncidenceAdded(const KCalendarCore::Incidence::Ptr &)
 {
+    calendarGroups.invalidate();
     triggerDelayedReload(MonthView::IncidencesAdded);
 }
 
-void MonthViewPrivate::calendarIncidenceChanged(const KCalendarCore::Incidence::Ptr &)
+void MonthViewPrivate::calendarIncidenceChanged(const KCalendarCore::Incidence::Ptr &incidence)
 {
+    // Don't paint stale texts until the reload happens
+    const auto items = scene->itemsForUid(incidence->uid());
+    for (IncidenceMonthItem *item : items) {
+        item->invalidateCache();
+    }
     triggerDelayedReload(MonthView::IncidencesEdited);
 }
 
@@ -181,6 +331,7 @@ void MonthViewPrivate::calendarIncidenceDeleted(const KCalendarCore::Incidence::
 {
     Q_UNUSED(calendar)
     Q_ASSERT(!incidence->uid().isEmpty());
+    calendarGroups.invalidate();
     scene->removeIncidence(incidence->uid());
 }
 
@@ -266,7 +417,7 @@ MonthView::MonthView(NavButtonsVisibility visibility, QWidget *parent)
     updateConfig();
 
     // d->setUpModels();
-    d->reloadTimer.start(50);
+    d->scheduleReload();
 }
 
 MonthView::~MonthView()
@@ -281,8 +432,9 @@ void MonthView::addCalendar(const Akonadi::CollectionCalendar::Ptr &calendar)
     if (calendar && calendar->collection().isValid()) {
         EventView::addCalendar(calendar);
         calendar->registerObserver(d.get());
+        d->calendarGroups.invalidate();
         setChanges(changes() | ResourcesChanged);
-        d->reloadTimer.start(50);
+        d->scheduleReload();
     }
 }
 
@@ -291,16 +443,18 @@ void MonthView::removeCalendar(const Akonadi::CollectionCalendar::Ptr &calendar)
     if (calendar && calendar->collection().isValid()) {
         EventView::removeCalendar(calendar);
         calendar->unregisterObserver(d.get());
+        d->calendarGroups.invalidate();
         setChanges(changes() | ResourcesChanged);
-        d->reloadTimer.start(50);
+        d->scheduleReload();
     }
 }
 
 void MonthView::updateConfig()
 {
+    d->scene->invalidateItemCaches();
     d->scene->update();
     setChanges(changes() | ConfigChanged);
-    d->reloadTimer.start(50);
+    d->scheduleReload();
 }
 
 int MonthView::currentDateCount() const
@@ -345,7 +499,7 @@ void MonthView::setDateRange(const QDateTime &start, const QDateTime &end, const
 {
     EventView::setDateRange(start, end, preferredMonth);
     setChanges(changes() | DatesChanged);
-    d->reloadTimer.start(50);
+    d->scheduleReload();
 }
 
 static QTime nextQuarterHour(const QTime &time)
@@ -423,7 +577,7 @@ void MonthView::changeIncidenceDisplay(const Akonadi::Item &incidence, int actio
     // called by one of the MonthItem objects. So only schedule a reload
     // as event
     setChanges(changes() | IncidencesEdited);
-    d->reloadTimer.start(50);
+    d->scheduleReload();
 }
 
 void MonthView::updateView()
@@ -521,7 +675,16 @@ QPair<QDateTime, QDateTime> MonthView::actualDateRange(const QDateTime &start, c
 {
     QDateTime dayOne = preferredMonth.isValid() ? QDateTime(preferredMonth.startOfDay()) : start;
 
-    dayOne.setDate(QDate(dayOne.date().year(), dayOne.date().month(), 1));
+    // With continuous scrolling the grid begins with the week of the first
+    // day asked for, so moving by a week moves the grid by a week. Otherwise
+    // it begins with the week of the first day of the month.
+    const bool startInMonth = !preferredMonth.isValid()
+        || (start.date().year() == preferredMonth.year() && start.date().month() == preferredMonth.month());
+    if (!d->continuousScrolling || !start.isValid() || !startInMonth) {
+        dayOne.setDate(QDate(dayOne.date().year(), dayOne.date().month(), 1));
+    } else {
+        dayOne = start;
+    }
     const int weekdayCol = (dayOne.date().dayOfWeek() + 7 - preferences()->firstDayOfWeek()) % 7;
     QDateTime actualStart = dayOne.addDays(-weekdayCol);
     actualStart.setTime(QTime(0, 0, 0, 0));
@@ -576,11 +739,8 @@ void MonthView::reloadIncidences()
     if (changes() == NothingChanged) {
         return;
     }
+    ++d->reloadCount;
     // keep selection if it exists
-    Akonadi::Item const incidenceSelected;
-
-    MonthItem *itemToReselect = nullptr;
-
     if (auto tmp = qobject_cast<IncidenceMonthItem *>(d->scene->selectedItem())) {
         d->selectedItemId = tmp->akonadiItem().id();
         d->selectedItemDate = tmp->realStartDate();
@@ -589,6 +749,15 @@ void MonthView::reloadIncidences()
         }
     }
 
+    const bool onlyDatesChanged = changes() == DatesChanged;
+    setChanges(NothingChanged);
+
+    if (onlyDatesChanged && d->scrollLoadedWeeks()) {
+        d->view->update();
+        d->scene->update();
+        return;
+    }
+
     d->scene->resetAll();
     d->mBusyDays.clear();
     // build monthcells hash
@@ -599,50 +768,17 @@ void MonthView::reloadIncidences()
     }
 
     // build global event list
-    const auto cals = calendars();
-    for (const auto &calendar : cals) {
-        auto *newItemToReselect = d->loadCalendarIncidences(calendar, actualStartDateTime(), actualEndDateTime());
-        if (itemToReselect == nullptr) {
-            itemToReselect = newItemToReselect;
-        }
-    }
+    d->loadOccurrences(actualStartDateTime().date(), actualEndDateTime().date());
 
-    if (itemToReselect) {
-        d->scene->selectItem(itemToReselect);
-    }
+    // sort it and give each occurrence its row in the cells
+    d->scene->layoutOccurrences();
 
-    // add holidays
-    if (preferences()->showHolidaysMonthView()) {
-        const QStringList holidayCats = CalendarSupport::KCalPrefs::instance()->holidayCategories();
-        auto const hols = holidays(actualStartDateTime().date(), actualEndDateTime().date(), holidayCats);
-        for (auto const &h : hols) {
-            /* cppcheck-suppress constVariablePointer */
-            MonthItem *holidayItem = new HolidayMonthItem(d->scene, h.observedStartDate(), h.observedEndDate(), h.name());
-            d->scene->mManagerList << holidayItem;
-        }
-    }
-
-    // sort it
-    std::sort(d->scene->mManagerList.begin(), d->scene->mManagerList.end(), MonthItem::greaterThan);
+    // only build items for the rows in view
+    d->scene->createVisibleMonthItems();
 
-    // build each month's cell event list
-    /* cppcheck-suppress constVariablePointer */
-    for (MonthItem *manager : std::as_const(d->scene->mManagerList)) {
-        for (QDate date = manager->startDate(); date <= manager->endDate(); date = date.addDays(1)) {
-            MonthCell *cell = d->scene->mMonthCellMap.value(date);
-            if (cell) {
-                cell->mMonthItemList << manager;
-            }
-        }
-    }
-
-    for (MonthItem *manager : std::as_const(d->scene->mManagerList)) {
-        manager->updateMonthGraphicsItems();
-        manager->updatePosition();
-    }
-
-    for (MonthItem *manager : std::as_const(d->scene->mManagerList)) {
-        manager->updateGeometry();
+    const qsizetype selectedIndex = d->scene->findOccurrence(d->selectedItemId, d->selectedItemDate);
+    if (selectedIndex >= 0) {
+        d->scene->selectItem(d->scene->monthItemForOccurrence(selectedIndex));
     }
 
     d->scene->setInitialized(true);
@@ -653,6 +789,7 @@ void MonthView::reloadIncidences()
 void MonthView::calendarReset()
 {
     qCDebug(CALENDARVIEW_LOG);
+    d->calendarGroups.invalidate();
     d->triggerDelayedReload(ResourcesChanged);
 }
 
@@ -688,6 +825,38 @@ void MonthView::showFullWindowButton(bool show)
     preferences()->writeConfig();
 }
 
+int MonthView::reloadCount() const
+{
+    return d->reloadCount;
+}
+
+int MonthView::coalescedReloadCount() const
+{
+    return d->reloadTimer.coalescedCount();
+}
+
+int MonthView::scrollReloadCount() const
+{
+    return d->scrollReloadCount;
+}
+
+bool MonthView::continuousScrolling() const
+{
+    return d->continuousScrolling;
+}
+
+void MonthView::setContinuousScrolling(bool enable)
+{
+    if (d->continuousScrolling == enable) {
+        return;
+    }
+    d->continuousScrolling = enable;
+    if (startDateTime().isValid()) {
+        // The grid may begin on another week now
+        setDateRange(startDateTime(), endDateTime());
+    }
+}
+
 bool MonthView::isBusyDay(QDate day) const
 {
     return !d->mBusyDays[day].isEmpty();
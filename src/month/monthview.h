@@ -110,6 +110,37 @@ public:
      */
     [[nodiscard]] bool isBusyDay(QDate day) const;
 
+    /*!
+     * Returns how many times the view was reloaded.
+     */
+    [[nodiscard]] int reloadCount() const;
+
+    /*!
+     * Returns how many change notifications were folded into an already
+     * scheduled reload instead of causing one of their own.
+     */
+    [[nodiscard]] int coalescedReloadCount() const;
+
+    /*!
+     * Returns how many of the reloads only scrolled the view by whole weeks
+     * and expanded the occurrences of the exposed weeks.
+     */
+    [[nodiscard]] int scrollReloadCount() const;
+
+    /*!
+     * Returns whether the grid begins with the week of the first day shown
+     * instead of the week of the first day of its month. Moving the view by
+     * a week then scrolls the grid by a week, keeping the weeks still in view
+     * instead of reloading all of them.
+     */
+    [[nodiscard]] bool continuousScrolling() const;
+
+    /*!
+     * Sets whether the grid scrolls by weeks instead of following the months.
+     * Disabled by default, so that the grid shows the whole month.
+     */
+    void setContinuousScrolling(bool enable);
+
     /*!
      */
     KHolidays::Holiday::List holidays(QDate startDate, QDate endDate, const QStringList &categories = QStringList());
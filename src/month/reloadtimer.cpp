@@ -0,0 +1,43 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM contributors <kde-pim@kde.org>
+
+  SPDX-License-Identifier: GPL-2.0-or-later WITH LicenseRef-Qt-Commercial-exception-1.0
+*/
+
+#include "reloadtimer.h"
+
+using namespace EventViews;
+
+static const int CHANGE_BURST_INTERVAL = 250; // changes closer than this form a burst
+static const int MIN_RELOAD_DELAY = 50;
+static const int MAX_RELOAD_DELAY = 1000;
+static const int MAX_RELOAD_STALENESS = 2000; // longest time a change waits for a reload
+
+ReloadTimer::ReloadTimer(QObject *parent)
+    : QTimer(parent)
+{
+    setSingleShot(true);
+}
+
+void ReloadTimer::schedule()
+{
+    const bool inBurst = mLastChangeTimer.isValid() && mLastChangeTimer.elapsed() < CHANGE_BURST_INTERVAL;
+    mLastChangeTimer.start();
+
+    if (isActive()) {
+        // Fold this change into the pending reload. Widen the window while
+        // notifications keep coming, but never let the oldest change wait
+        // longer than MAX_RELOAD_STALENESS.
+        ++mCoalescedCount;
+        mDelay = qBound(MIN_RELOAD_DELAY, mDelay * 2, MAX_RELOAD_DELAY);
+        const int remaining = MAX_RELOAD_STALENESS - static_cast<int>(mPendingTimer.elapsed());
+        start(qBound(0, remaining, mDelay));
+        return;
+    }
+
+    // Within a burst, start from the previous window and let it shrink as
+    // the rate goes down
+    mPendingTimer.start();
+    mDelay = inBurst ? qMax(MIN_RELOAD_DELAY, mDelay / 2) : 0;
+    start(mDelay);
+}
@@ -0,0 +1,46 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM contributors <kde-pim@kde.org>
+
+  SPDX-License-Identifier: GPL-2.0-or-later WITH LicenseRef-Qt-Commercial-exception-1.0
+*/
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QTimer>
+
+namespace EventViews
+{
+/**
+ * Single shot timer coalescing the reloads requested by change notifications.
+ *
+ * A lone change is applied on the next event loop iteration. While changes
+ * keep coming, e.g. during a sync, they are folded into the pending reload
+ * and the window widens, but the oldest change never waits longer than a
+ * bounded time. Connect to timeout() to do the reload.
+ */
+class ReloadTimer : public QTimer
+{
+public:
+    explicit ReloadTimer(QObject *parent = nullptr);
+
+    /**
+      Schedules a reload, or folds the change into the pending one.
+    */
+    void schedule();
+
+    /**
+      Returns how many changes were folded into an already scheduled reload.
+    */
+    [[nodiscard]] int coalescedCount() const
+    {
+        return mCoalescedCount;
+    }
+
+private:
+    QElapsedTimer mLastChangeTimer; // since the last change notification
+    QElapsedTimer mPendingTimer; // since the oldest change not reloaded yet
+    int mDelay = 0;
+    int mCoalescedCount = 0;
+};
+}
@@ -0,0 +1,82 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM contributors <kde-pim@kde.org>
+
+  SPDX-License-Identifier: GPL-2.0-or-later WITH LicenseRef-Qt-Commercial-exception-1.0
+*/
+
+#include "yeardensity.h"
+#include "monthitem.h"
+
+#include <KCalendarCore/Event>
+#include <KCalendarCore/OccurrenceIterator>
+
+using namespace EventViews;
+
+static const int MINUTES_PER_DAY = 24 * 60;
+
+YearDensity YearDensity::aggregate(const KCalendarCore::Calendar &calendar, QDate firstDay, QDate lastDay, bool showTodos, bool showJournals)
+{
+    const int dayCount = firstDay.daysTo(lastDay) + 1;
+    YearDensity result;
+    result.counts.fill(0, dayCount);
+    result.busyMinutes.fill(0, dayCount);
+
+    KCalendarCore::OccurrenceIterator occurIter(calendar, firstDay.startOfDay(), lastDay.endOfDay());
+    while (occurIter.hasNext()) {
+        occurIter.next();
+
+        const KCalendarCore::Incidence::Ptr incidence = occurIter.incidence();
+        if (!showTodos && incidence->type() == KCalendarCore::Incidence::TypeTodo) {
+            continue;
+        }
+        if (!showJournals && incidence->type() == KCalendarCore::Incidence::TypeJournal) {
+            continue;
+        }
+
+        // Same days as the month view covers with the occurrence's item
+        const QDate recurStartDate = occurIter.occurrenceStartDate().toLocalTime().date();
+        const int offset = IncidenceMonthItem::recurDayOffset(incidence, recurStartDate);
+        const QDate start = qMax(IncidenceMonthItem::displayStartDate(incidence, offset), firstDay);
+        const QDate end = qMin(IncidenceMonthItem::displayEndDate(incidence, offset), lastDay);
+        if (!start.isValid() || !end.isValid() || start > end) {
+            continue;
+        }
+
+        bool busy = false;
+        if (incidence->type() == KCalendarCore::Incidence::TypeEvent) {
+            busy = incidence.staticCast<KCalendarCore::Event>()->transparency() == KCalendarCore::Event::Opaque;
+        }
+        const QDateTime busyStart = incidence->dateTime(KCalendarCore::Incidence::RoleDisplayStart).toLocalTime().addDays(offset);
+        const QDateTime busyEnd = incidence->dateTime(KCalendarCore::Incidence::RoleDisplayEnd).toLocalTime().addDays(offset);
+
+        for (QDate date = start; date <= end; date = date.addDays(1)) {
+            const int index = firstDay.daysTo(date);
+            ++result.counts[index];
+            if (!busy) {
+                continue;
+            }
+            int minutes = MINUTES_PER_DAY;
+            if (!incidence->allDay()) {
+                const QDateTime from = qMax(busyStart, date.startOfDay());
+                const QDateTime to = qMin(busyEnd, date.addDays(1).startOfDay());
+                minutes = qMax(0, static_cast<int>(from.secsTo(to) / 60));
+            }
+            result.busyMinutes[index] = qMin(MINUTES_PER_DAY, result.busyMinutes[index] + minutes);
+        }
+    }
+
+    return result;
+}
+
+void YearDensity::add(const YearDensity &other)
+{
+    if (counts.isEmpty()) {
+        *this = other;
+        return;
+    }
+    Q_ASSERT(other.counts.size() == counts.size());
+    for (qsizetype i = 0; i < counts.size(); ++i) {
+        counts[i] += other.counts.at(i);
+        busyMinutes[i] = qMin(MINUTES_PER_DAY, busyMinutes.at(i) + other.busyMinutes.at(i));
+    }
+}
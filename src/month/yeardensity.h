@@ -0,0 +1,44 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM contributors <kde-pim@kde.org>
+
+  SPDX-License-Identifier: GPL-2.0-or-later WITH LicenseRef-Qt-Commercial-exception-1.0
+*/
+
+#pragma once
+
+#include "eventviews_private_export.h"
+
+#include <QDate>
+#include <QList>
+
+namespace KCalendarCore
+{
+class Calendar;
+}
+
+namespace EventViews
+{
+/*!
+ * Per day values shown by the year view, index 0 being its first day.
+ */
+struct EVENTVIEWS_TESTS_EXPORT YearDensity {
+    QList<int> counts; ///< Number of occurrences on the day
+    QList<int> busyMinutes; ///< Minutes blocked by opaque events on the day
+
+    /*!
+      Returns the values of the days from \a firstDay to \a lastDay, found in
+      one pass over the occurrences of \a calendar. An occurrence counts on
+      the days its month view item covers.
+
+      Doesn't touch any view, so it can run in a worker thread, as long as
+      no other thread expands incidences of \a calendar.
+    */
+    [[nodiscard]] static YearDensity aggregate(const KCalendarCore::Calendar &calendar, QDate firstDay, QDate lastDay, bool showTodos, bool showJournals);
+
+    /*!
+      Adds the values of \a other, which covers the same days.
+      Busy minutes are capped at a full day.
+    */
+    void add(const YearDensity &other);
+};
+}
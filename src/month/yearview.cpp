@@ -0,0 +1,542 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM contributors <kde-pim@kde.org>
+
+  SPDX-License-Identifier: GPL-2.0-or-later WITH LicenseRef-Qt-Commercial-exception-1.0
+*/
+
+#include "yearview.h"
+#include "calendargroups.h"
+#include "helper.h"
+#include "monthscene.h"
+#include "prefs.h"
+#include "reloadtimer.h"
+#include "yeardensity.h"
+
+#include "calendarview_debug.h"
+#include <KConfigGroup>
+#include <KLocalizedString>
+
+#include <QContextMenuEvent>
+#include <QHBoxLayout>
+#include <QHelpEvent>
+#include <QMenu>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QTimer>
+#include <QToolTip>
+#include <QtConcurrentMap>
+
+using namespace EventViews;
+
+static const int DAYS_PER_WEEK = 7;
+static const int WEEKS_PER_MONTH = 6; // rows of a mini month, as many as the month view has
+static const int MONTH_SPACING = 8;
+
+namespace
+{
+// Paints the twelve months and forwards the user interaction to the view
+class YearGrid : public QWidget
+{
+public:
+    explicit YearGrid(YearViewPrivate *dd, QWidget *parent);
+
+protected:
+    bool event(QEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+    void contextMenuEvent(QContextMenuEvent *event) override;
+
+private:
+    [[nodiscard]] int titleHeight() const;
+    [[nodiscard]] QRect monthRect(int month) const;
+    [[nodiscard]] QRect dayRect(const QRect &monthRect, QDate date) const;
+    [[nodiscard]] QDate dateAt(QPoint pos) const;
+
+    YearViewPrivate *const d;
+};
+}
+
+namespace EventViews
+{
+class YearViewPrivate : public KCalendarCore::Calendar::CalendarObserver
+{
+    YearView *const q;
+
+public: /// Methods
+    explicit YearViewPrivate(YearView *qq);
+
+    void reload();
+    [[nodiscard]] int dayIndex(QDate date) const;
+    [[nodiscard]] int value(QDate date) const;
+
+    /// Members
+    ReloadTimer reloadTimer;
+    CalendarGroups calendarGroups;
+    YearGrid *grid = nullptr;
+    YearView::DensityMode mode = YearView::OccurrenceCount;
+    QDate firstDay;
+    YearDensity density; // index 0 being firstDay
+    int maxCount = 0;
+    int maxBusyMinutes = 0;
+    QDate selectedDate;
+
+protected:
+    /* reimplemented from KCalendarCore::Calendar::CalendarObserver */
+    void calendarIncidenceAdded(const KCalendarCore::Incidence::Ptr &incidence) override;
+    void calendarIncidenceChanged(const KCalendarCore::Incidence::Ptr &incidence) override;
+    void calendarIncidenceDeleted(const KCalendarCore::Incidence::Ptr &incidence, const KCalendarCore::Calendar *calendar) override;
+
+private:
+    // quiet --overloaded-virtual warning
+    using KCalendarCore::Calendar::CalendarObserver::calendarIncidenceDeleted;
+};
+}
+
+YearViewPrivate::YearViewPrivate(YearView *qq)
+    : q(qq)
+    , grid(new YearGrid(this, qq))
+{
+}
+
+void YearViewPrivate::reload()
+{
+    firstDay = q->actualStartDateTime().date();
+    const QDate lastDay = q->actualEndDateTime().date();
+    density = {};
+    maxCount = 0;
+    maxBusyMinutes = 0;
+    if (!firstDay.isValid() || !lastDay.isValid()) {
+        grid->update();
+        return;
+    }
+
+    // One pass over the occurrences of the year per calendar, on the thread
+    // pool. Calendars sharing incidences are aggregated by the same task, see
+    // groupCalendarsBySharedIncidences(). The groups are cached, see CalendarGroups.
+    const auto cals = q->calendars();
+    const bool showTodos = q->preferences()->showTodosMonthView();
+    const bool showJournals = q->preferences()->showJournalsMonthView();
+    const QDate first = firstDay;
+    const auto aggregateGroup = [&cals, first, lastDay, showTodos, showJournals](const QList<qsizetype> &group) {
+        YearDensity groupDensity;
+        for (qsizetype index : group) {
+            groupDensity.add(YearDensity::aggregate(*cals.at(index), first, lastDay, showTodos, showJournals));
+        }
+        return groupDensity;
+    };
+    const auto perGroup = QtConcurrent::blockingMapped<QList<YearDensity>>(calendarGroups.groups(cals), aggregateGroup);
+    const int dayCount = first.daysTo(lastDay) + 1;
+    density.counts.fill(0, dayCount);
+    density.busyMinutes.fill(0, dayCount);
+    for (const YearDensity &groupDensity : perGroup) {
+        density.add(groupDensity);
+    }
+    for (int i = 0; i < dayCount; ++i) {
+        maxCount = qMax(maxCount, density.counts.at(i));
+        maxBusyMinutes = qMax(maxBusyMinutes, density.busyMinutes.at(i));
+    }
+
+    grid->update();
+}
+
+int YearViewPrivate::dayIndex(QDate date) const
+{
+    if (!firstDay.isValid() || !date.isValid()) {
+        return -1;
+    }
+    const qint64 index = firstDay.daysTo(date);
+    return (index >= 0 && index < density.counts.size()) ? static_cast<int>(index) : -1;
+}
+
+int YearViewPrivate::value(QDate date) const
+{
+    const int index = dayIndex(date);
+    if (index < 0) {
+        return 0;
+    }
+    return mode == YearView::BusyMinutes ? density.busyMinutes.at(index) : density.counts.at(index);
+}
+
+void YearViewPrivate::calendarIncidenceAdded(const KCalendarCore::Incidence::Ptr &)
+{
+    calendarGroups.invalidate();
+    reloadTimer.schedule();
+}
+
+void YearViewPrivate::calendarIncidenceChanged(const KCalendarCore::Incidence::Ptr &)
+{
+    reloadTimer.schedule();
+}
+
+void YearViewPrivate::calendarIncidenceDeleted(const KCalendarCore::Incidence::Ptr &, const KCalendarCore::Calendar *)
+{
+    calendarGroups.invalidate();
+    reloadTimer.schedule();
+}
+
+/// YearGrid
+
+YearGrid::YearGrid(YearViewPrivate *dd, QWidget *parent)
+    : QWidget(parent)
+    , d(dd)
+{
+    setFocusPolicy(Qt::ClickFocus);
+}
+
+int YearGrid::titleHeight() const
+{
+    return fontMetrics().height() * 2;
+}
+
+QRect YearGrid::monthRect(int month) const
+{
+    // Keep the months roughly square: 4x3 on wide widgets, 3x4 on tall ones
+    const int columns = width() >= height() ? 4 : 3;
+    const int rows = 12 / columns;
+    const QRect area = rect().adjusted(MONTH_SPACING, titleHeight(), -MONTH_SPACING, -MONTH_SPACING);
+    const int monthWidth = (area.width() - (columns - 1) * MONTH_SPACING) / columns;
+    const int monthHeight = (area.height() - (rows - 1) * MONTH_SPACING) / rows;
+    const int column = (month - 1) % columns;
+    const int row = (month - 1) / columns;
+    return {area.left() + column * (monthWidth + MONTH_SPACING), area.top() + row * (monthHeight + MONTH_SPACING), monthWidth, monthHeight};
+}
+
+QRect YearGrid::dayRect(const QRect &monthRect, QDate date) const
+{
+    // Month name and weekday initials take a line each
+    const int lineHeight = fontMetrics().height();
+    const int cellWidth = monthRect.width() / DAYS_PER_WEEK;
+    const int cellHeight = (monthRect.height() - 2 * lineHeight) / WEEKS_PER_MONTH;
+    const int firstDayOfWeek = static_cast<YearView *>(parentWidget())->preferences()->firstDayOfWeek();
+    const int firstColumn = (QDate(date.year(), date.month(), 1).dayOfWeek() + DAYS_PER_WEEK - firstDayOfWeek) % DAYS_PER_WEEK;
+    const int cell = firstColumn + date.day() - 1;
+    return {monthRect.left() + (cell % DAYS_PER_WEEK) * cellWidth, monthRect.top() + 2 * lineHeight + (cell / DAYS_PER_WEEK) * cellHeight, cellWidth, cellHeight};
+}
+
+QDate YearGrid::dateAt(QPoint pos) const
+{
+    if (!d->firstDay.isValid()) {
+        return {};
+    }
+    const int year = d->firstDay.year();
+    for (int month = 1; month <= 12; ++month) {
+        const QRect rect = monthRect(month);
+        if (!rect.contains(pos)) {
+            continue;
+        }
+        const QDate first(year, month, 1);
+        for (QDate date = first; date.month() == month; date = date.addDays(1)) {
+            if (dayRect(rect, date).contains(pos)) {
+                return date;
+            }
+        }
+        return {};
+    }
+    return {};
+}
+
+bool YearGrid::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip) {
+        auto helpEvent = static_cast<QHelpEvent *>(event);
+        const QDate date = dateAt(helpEvent->pos());
+        const int index = d->dayIndex(date);
+        if (index < 0) {
+            QToolTip::hideText();
+            event->ignore();
+            return true;
+        }
+        const int minutes = d->density.busyMinutes.at(index);
+        const QString busy = i18nc("@info:tooltip hours and minutes", "%1:%2", minutes / 60, QString::number(minutes % 60).rightJustified(2, u'0'));
+        QToolTip::showText(helpEvent->globalPos(),
+                           i18ncp("@info:tooltip",
+                                  "%2<br/>%1 occurrence, %3 busy",
+                                  "%2<br/>%1 occurrences, %3 busy",
+                                  d->density.counts.at(index),
+                                  QLocale::system().toString(date, QLocale::LongFormat),
+                                  busy),
+                           this);
+        return true;
+    }
+    return QWidget::event(event);
+}
+
+void YearGrid::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event)
+    auto view = static_cast<YearView *>(parentWidget());
+    const PrefsPtr prefs = view->preferences();
+
+    QPainter p(this);
+    p.fillRect(rect(), palette().color(QPalette::Window));
+    if (!d->firstDay.isValid()) {
+        return;
+    }
+
+    const QFont font = prefs->monthViewFont();
+    const int year = d->firstDay.year();
+
+    QFont titleFont = font;
+    titleFont.setBold(true);
+    titleFont.setPointSizeF(font.pointSizeF() * 1.5);
+    p.setFont(titleFont);
+    p.setPen(palette().color(QPalette::WindowText));
+    p.drawText(QRect(0, 0, width(), titleHeight()), Qt::AlignCenter, QString::number(year));
+    p.setFont(font);
+
+    // Same cell colors as the month view
+    const QColor baseColor = MonthGraphicsView::cellBackground(prefs, palette(), true);
+    const QColor busyColor = prefs->viewBgBusyColor();
+    const QColor gridColor = MonthGraphicsView::gridColor(prefs);
+    const int maximum = d->mode == YearView::BusyMinutes ? d->maxBusyMinutes : d->maxCount;
+    const int firstDayOfWeek = prefs->firstDayOfWeek();
+    const QDate todayDate = QDate::currentDate();
+    const int lineHeight = fontMetrics().height();
+
+    QRect todayRect;
+    QRect selectedRect;
+    for (int month = 1; month <= 12; ++month) {
+        const QRect rect = monthRect(month);
+        const int cellWidth = rect.width() / DAYS_PER_WEEK;
+
+        QFont boldFont = font;
+        boldFont.setBold(true);
+        p.setFont(boldFont);
+        p.setPen(palette().color(QPalette::WindowText));
+        p.drawText(QRect(rect.left(), rect.top(), rect.width(), lineHeight), Qt::AlignCenter, QLocale::system().standaloneMonthName(month));
+        p.setFont(font);
+        for (int column = 0; column < DAYS_PER_WEEK; ++column) {
+            const int dayOfWeek = (firstDayOfWeek - 1 + column) % DAYS_PER_WEEK + 1;
+            p.drawText(QRect(rect.left() + column * cellWidth, rect.top() + lineHeight, cellWidth, lineHeight),
+                       Qt::AlignCenter,
+                       QLocale::system().standaloneDayName(dayOfWeek, QLocale::NarrowFormat));
+        }
+
+        for (QDate date(year, month, 1); date.month() == month; date = date.addDays(1)) {
+            const QRect cellRect = dayRect(rect, date);
+            const int value = d->value(date);
+
+            // Blend from the grid background towards the busy color
+            QColor color = baseColor;
+            if (value > 0 && maximum > 0) {
+                const qreal ratio = qMin(1.0, static_cast<qreal>(value) / maximum);
+                color.setRgbF(baseColor.redF() + (busyColor.redF() - baseColor.redF()) * ratio,
+                              baseColor.greenF() + (busyColor.greenF() - baseColor.greenF()) * ratio,
+                              baseColor.blueF() + (busyColor.blueF() - baseColor.blueF()) * ratio);
+            }
+            p.setPen(gridColor);
+            p.setBrush(color);
+            p.drawRect(cellRect);
+            p.setPen(EventViews::getTextColor(color));
+            p.drawText(cellRect, Qt::AlignCenter, QString::number(date.day()));
+
+            if (date == todayDate) {
+                todayRect = cellRect;
+            }
+            if (date == d->selectedDate) {
+                selectedRect = cellRect;
+            }
+        }
+    }
+
+    p.setBrush(Qt::NoBrush);
+    if (!todayRect.isNull()) {
+        p.setPen(QPen(prefs->monthTodayColor(), 2));
+        p.drawRect(todayRect.adjusted(1, 1, -1, -1));
+    }
+    if (!selectedRect.isNull()) {
+        MonthGraphicsView::drawSelection(&p, selectedRect);
+    }
+}
+
+void YearGrid::mousePressEvent(QMouseEvent *event)
+{
+    const QDate date = dateAt(event->position().toPoint());
+    if (date != d->selectedDate) {
+        d->selectedDate = date;
+        update();
+    }
+    QWidget::mousePressEvent(event);
+}
+
+void YearGrid::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    const QDate date = dateAt(event->position().toPoint());
+    if (date.isValid()) {
+        Q_EMIT static_cast<YearView *>(parentWidget())->datesSelected(KCalendarCore::DateList{date});
+    }
+}
+
+void YearGrid::contextMenuEvent(QContextMenuEvent *event)
+{
+    auto view = static_cast<YearView *>(parentWidget());
+
+    QMenu menu(this);
+    QAction *countAction = menu.addAction(i18nc("@action:inmenu", "Show Number of Occurrences"));
+    countAction->setCheckable(true);
+    countAction->setChecked(d->mode == YearView::OccurrenceCount);
+    QAction *busyAction = menu.addAction(i18nc("@action:inmenu", "Show Busy Time"));
+    busyAction->setCheckable(true);
+    busyAction->setChecked(d->mode == YearView::BusyMinutes);
+
+    QAction *chosen = menu.exec(event->globalPos());
+    if (chosen == countAction) {
+        view->setDensityMode(YearView::OccurrenceCount);
+    } else if (chosen == busyAction) {
+        view->setDensityMode(YearView::BusyMinutes);
+    }
+}
+
+/// YearView
+
+YearView::YearView(QWidget *parent)
+    : EventView(parent)
+    , d(new YearViewPrivate(this))
+{
+    auto topLayout = new QHBoxLayout(this);
+    topLayout->addWidget(d->grid);
+    topLayout->setContentsMargins({});
+
+    connect(&d->reloadTimer, &QTimer::timeout, this, [this]() {
+        d->reload();
+    });
+    updateConfig();
+}
+
+YearView::~YearView()
+{
+    for (auto &calendar : calendars()) {
+        calendar->unregisterObserver(d.get());
+    }
+}
+
+void YearView::addCalendar(const Akonadi::CollectionCalendar::Ptr &calendar)
+{
+    if (calendar && calendar->collection().isValid()) {
+        EventView::addCalendar(calendar);
+        calendar->registerObserver(d.get());
+        d->calendarGroups.invalidate();
+        d->reloadTimer.schedule();
+    }
+}
+
+void YearView::removeCalendar(const Akonadi::CollectionCalendar::Ptr &calendar)
+{
+    if (calendar && calendar->collection().isValid()) {
+        EventView::removeCalendar(calendar);
+        calendar->unregisterObserver(d.get());
+        d->calendarGroups.invalidate();
+        d->reloadTimer.schedule();
+    }
+}
+
+int YearView::currentDateCount() const
+{
+    return actualStartDateTime().date().daysTo(actualEndDateTime().date());
+}
+
+Akonadi::Item::List YearView::selectedIncidences() const
+{
+    return {};
+}
+
+KCalendarCore::DateList YearView::selectedIncidenceDates() const
+{
+    return {};
+}
+
+QDateTime YearView::selectionStart() const
+{
+    if (d->selectedDate.isValid()) {
+        return d->selectedDate.startOfDay();
+    }
+    return {};
+}
+
+QDateTime YearView::selectionEnd() const
+{
+    // Only one day can be selected
+    return selectionStart();
+}
+
+void YearView::setDateRange(const QDateTime &start, const QDateTime &end, const QDate &preferredMonth)
+{
+    EventView::setDateRange(start, end, preferredMonth);
+    d->reloadTimer.schedule();
+}
+
+YearView::DensityMode YearView::densityMode() const
+{
+    return d->mode;
+}
+
+void YearView::setDensityMode(DensityMode mode)
+{
+    if (d->mode != mode) {
+        d->mode = mode;
+        d->grid->update();
+    }
+}
+
+int YearView::occurrenceCount(QDate date) const
+{
+    const int index = d->dayIndex(date);
+    return index < 0 ? 0 : d->density.counts.at(index);
+}
+
+int YearView::busyMinutes(QDate date) const
+{
+    const int index = d->dayIndex(date);
+    return index < 0 ? 0 : d->density.busyMinutes.at(index);
+}
+
+void YearView::updateConfig()
+{
+    d->grid->update();
+    d->reloadTimer.schedule();
+}
+
+void YearView::updateView()
+{
+    d->grid->update();
+}
+
+void YearView::showIncidences(const Akonadi::Item::List &incidenceList, const QDate &date)
+{
+    Q_UNUSED(incidenceList)
+    Q_UNUSED(date)
+}
+
+void YearView::calendarReset()
+{
+    qCDebug(CALENDARVIEW_LOG);
+    d->calendarGroups.invalidate();
+    d->reloadTimer.schedule();
+}
+
+QPair<QDateTime, QDateTime> YearView::actualDateRange(const QDateTime &start, const QDateTime &, const QDate &preferredMonth) const
+{
+    const int year = preferredMonth.isValid() ? preferredMonth.year() : start.date().year();
+    return qMakePair(QDate(year, 1, 1).startOfDay(), QDate(year, 12, 31).endOfDay());
+}
+
+void YearView::showDates(const QDate &start, const QDate &end, const QDate &preferedMonth)
+{
+    Q_UNUSED(start)
+    Q_UNUSED(end)
+    Q_UNUSED(preferedMonth)
+    d->reloadTimer.schedule();
+}
+
+void YearView::doRestoreConfig(const KConfigGroup &configGroup)
+{
+    setDensityMode(configGroup.readEntry("DensityMode", 0) == BusyMinutes ? BusyMinutes : OccurrenceCount);
+}
+
+void YearView::doSaveConfig(KConfigGroup &configGroup)
+{
+    configGroup.writeEntry("DensityMode", static_cast<int>(d->mode));
+}
+
+#include "moc_yearview.cpp"
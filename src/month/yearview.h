@@ -0,0 +1,136 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM contributors <kde-pim@kde.org>
+
+  SPDX-License-Identifier: GPL-2.0-or-later WITH LicenseRef-Qt-Commercial-exception-1.0
+*/
+
+#pragma once
+
+#include "eventview.h"
+
+#include <memory>
+
+namespace EventViews
+{
+class YearViewPrivate;
+
+/*!
+  \class EventViews::YearView
+  \inmodule EventViews
+  \inheaderfile EventViews/YearView
+
+  Twelve month overview showing how busy each day is.
+
+  Instead of one item per incidence, every day is painted as a cell of a
+  heatmap whose intensity is either the number of occurrences on that day
+  or the number of minutes blocked by opaque events. The values come from
+  a single pass over the occurrences of the whole year.
+*/
+class EVENTVIEWS_EXPORT YearView : public EventView
+{
+    Q_OBJECT
+public:
+    enum DensityMode {
+        OccurrenceCount, ///< Number of occurrences on the day
+        BusyMinutes ///< Minutes blocked by opaque events on the day
+    };
+    Q_ENUM(DensityMode)
+
+    /*!
+     */
+    explicit YearView(QWidget *parent = nullptr);
+    /*!
+     */
+    ~YearView() override;
+
+    /*!
+     */
+    void addCalendar(const Akonadi::CollectionCalendar::Ptr &calendar) override;
+    /*!
+     */
+    void removeCalendar(const Akonadi::CollectionCalendar::Ptr &calendar) override;
+
+    /*!
+     */
+    [[nodiscard]] int currentDateCount() const override;
+
+    /*!
+     * The year view doesn't show individual incidences, so nothing can be selected.
+     */
+    [[nodiscard]] Akonadi::Item::List selectedIncidences() const override;
+
+    /*!
+     */
+    [[nodiscard]] KCalendarCore::DateList selectedIncidenceDates() const override;
+
+    /*!
+     */
+    [[nodiscard]] QDateTime selectionStart() const override;
+
+    /*!
+     */
+    [[nodiscard]] QDateTime selectionEnd() const override;
+
+    /*!
+     */
+    void setDateRange(const QDateTime &start, const QDateTime &end, const QDate &preferredMonth = QDate()) override;
+
+    /*!
+     * Returns what the intensity of the day cells represents.
+     */
+    [[nodiscard]] DensityMode densityMode() const;
+
+    /*!
+     * Sets what the intensity of the day cells represents.
+     */
+    void setDensityMode(DensityMode mode);
+
+    /*!
+     * Returns the number of occurrences on \a date, or 0 if \a date isn't shown.
+     */
+    [[nodiscard]] int occurrenceCount(QDate date) const;
+
+    /*!
+     * Returns how many minutes of \a date are blocked by opaque events,
+     * or 0 if \a date isn't shown.
+     */
+    [[nodiscard]] int busyMinutes(QDate date) const;
+
+public Q_SLOTS:
+    /*!
+     */
+    void updateConfig() override;
+    /*!
+     */
+    void updateView() override;
+    /*!
+     */
+    void showIncidences(const Akonadi::Item::List &incidenceList, const QDate &date) override;
+
+protected Q_SLOTS:
+    /*!
+     */
+    void calendarReset() override;
+
+protected:
+    /*!
+     */
+    QPair<QDateTime, QDateTime> actualDateRange(const QDateTime &start, const QDateTime &end, const QDate &preferredMonth = QDate()) const override;
+
+    /*!
+     * \deprecated
+     */
+    void showDates(const QDate &start, const QDate &end, const QDate &preferedMonth = QDate()) override;
+
+    /*!
+     */
+    void doRestoreConfig(const KConfigGroup &configGroup) override;
+    /*!
+     */
+    void doSaveConfig(KConfigGroup &configGroup) override;
+
+private:
+    std::unique_ptr<YearViewPrivate> const d;
+    friend class YearViewPrivate;
+};
+}
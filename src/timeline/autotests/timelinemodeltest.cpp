@@ -0,0 +1,247 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KDE PIM contributors <kde-pim@kde.org>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <QTest>
+
+#include "../timelinemodel.h"
+
+#include <KGanttGlobal>
+
+#include <QAbstractItemModelTester>
+#include <QSignalSpy>
+
+using namespace EventViews;
+
+namespace
+{
+class TimelineModelTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void modelTester();
+    void appendSkipsDuplicates();
+    void removeLeavesEmptyColumns();
+    void setDataEmitsOccurrenceChanged();
+    void removeCalendarRow();
+    void removeByUid();
+
+public:
+    [[nodiscard]] static TimelineOccurrence occurrence(Akonadi::Item::Id id, int hour);
+    [[nodiscard]] static QList<Akonadi::Item::Id> items(const TimelineModel &model, int row);
+};
+
+TimelineOccurrence TimelineModelTest::occurrence(Akonadi::Item::Id id, int hour)
+{
+    TimelineOccurrence occurrence;
+    occurrence.item = Akonadi::Item(id);
+    occurrence.start = QDateTime(QDate(2026, 3, 4), QTime(hour, 0));
+    occurrence.originalStart = occurrence.start;
+    occurrence.end = occurrence.start.addSecs(3600);
+    return occurrence;
+}
+
+QList<Akonadi::Item::Id> TimelineModelTest::items(const TimelineModel &model, int row)
+{
+    QList<Akonadi::Item::Id> ids;
+    for (int column = 1; column < model.columnCount(); ++column) {
+        if (const TimelineOccurrence *occurrence = model.occurrence(model.index(row, column))) {
+            ids.append(occurrence->item.id());
+        }
+    }
+    return ids;
+}
+
+/**
+ * The model stays consistent while rows and occurrences come and go.
+ */
+void TimelineModelTest::modelTester()
+{
+    TimelineModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+
+    model.insertCalendarRow(0, {});
+    model.insertCalendarRow(0, {});
+    model.insertCalendarRow(5, {});
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(model.columnCount(), 1);
+
+    model.appendOccurrences(0, {occurrence(1, 8), occurrence(1, 9), occurrence(2, 10)});
+    model.appendOccurrences(2, {occurrence(3, 8)});
+    model.appendOccurrences(2, {occurrence(4, 8), occurrence(4, 12), occurrence(5, 13), occurrence(5, 14)});
+    QCOMPARE(model.columnCount(), 6);
+    model.setRowColor(2, Qt::red);
+    QCOMPARE(model.index(2, 1).data(Qt::DecorationRole).value<QColor>(), QColor(Qt::red));
+
+    model.moveOccurrences(0, Akonadi::Item(1), 3600, 1800);
+    QCOMPARE(model.index(0, 1).data(KGantt::StartTimeRole).toDateTime(), occurrence(1, 9).start);
+    QCOMPARE(model.index(0, 2).data(KGantt::EndTimeRole).toDateTime(), occurrence(1, 10).start.addSecs(1800));
+
+    model.removeOccurrences(2, Akonadi::Item(4));
+    QCOMPARE(items(model, 2), QList<Akonadi::Item::Id>({3, 5, 5}));
+    model.appendOccurrences(1, {occurrence(6, 8)});
+    QCOMPARE(model.columnCount(), 6);
+
+    model.clear();
+    QCOMPARE(model.rowCount(), 0);
+    QCOMPARE(model.columnCount(), 1);
+}
+
+/**
+ * Occurrences already shown with the same start and end are skipped, both
+ * within one call and across calls.
+ */
+void TimelineModelTest::appendSkipsDuplicates()
+{
+    TimelineModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    model.insertCalendarRow(0, {});
+
+    model.appendOccurrences(0, {occurrence(1, 8), occurrence(1, 8), occurrence(2, 8)});
+    QCOMPARE(items(model, 0), QList<Akonadi::Item::Id>({1, 2}));
+
+    QSignalSpy columnsInserted(&model, &QAbstractItemModel::columnsInserted);
+    QSignalSpy dataChanged(&model, &QAbstractItemModel::dataChanged);
+    model.appendOccurrences(0, {occurrence(2, 8), occurrence(1, 8)});
+    QCOMPARE(items(model, 0), QList<Akonadi::Item::Id>({1, 2}));
+    QCOMPARE(columnsInserted.count(), 0);
+    QCOMPARE(dataChanged.count(), 0);
+
+    model.appendOccurrences(0, {occurrence(1, 8), occurrence(1, 9)});
+    QCOMPARE(items(model, 0), QList<Akonadi::Item::Id>({1, 2, 1}));
+
+    // Removing an item forgets its times, so it can be shown again
+    model.removeOccurrences(0, Akonadi::Item(1));
+    model.appendOccurrences(0, {occurrence(1, 8)});
+    QCOMPARE(items(model, 0), QList<Akonadi::Item::Id>({2, 1}));
+}
+
+/**
+ * Removing occurrences shifts the later ones to the left and leaves the last
+ * columns of the row empty, without removing any column.
+ */
+void TimelineModelTest::removeLeavesEmptyColumns()
+{
+    TimelineModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    model.insertCalendarRow(0, {});
+    model.appendOccurrences(0, {occurrence(1, 8), occurrence(2, 9), occurrence(1, 10), occurrence(3, 11)});
+    QCOMPARE(model.columnCount(), 5);
+
+    QSignalSpy columnsRemoved(&model, &QAbstractItemModel::columnsRemoved);
+    QSignalSpy dataChanged(&model, &QAbstractItemModel::dataChanged);
+    model.removeOccurrences(0, Akonadi::Item(1));
+    QCOMPARE(columnsRemoved.count(), 0);
+    QCOMPARE(model.columnCount(), 5);
+    QCOMPARE(items(model, 0), QList<Akonadi::Item::Id>({2, 3}));
+    QCOMPARE(dataChanged.count(), 1);
+    QCOMPARE(dataChanged.at(0).at(0).value<QModelIndex>(), model.index(0, 1));
+    QCOMPARE(dataChanged.at(0).at(1).value<QModelIndex>(), model.index(0, 4));
+
+    for (int column = 3; column < model.columnCount(); ++column) {
+        const QModelIndex empty = model.index(0, column);
+        QVERIFY(empty.isValid());
+        QVERIFY(!model.occurrence(empty));
+        QVERIFY(!empty.data(KGantt::ItemTypeRole).isValid());
+        QCOMPARE(model.flags(empty), Qt::ItemFlags());
+    }
+
+    // Other items aren't touched
+    model.removeOccurrences(0, Akonadi::Item(4));
+    QCOMPARE(dataChanged.count(), 1);
+}
+
+/**
+ * Moving a bar in the view is reported, with the new times.
+ */
+void TimelineModelTest::setDataEmitsOccurrenceChanged()
+{
+    TimelineModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    model.insertCalendarRow(0, {});
+    model.appendOccurrences(0, {occurrence(1, 8), occurrence(2, 8)});
+
+    QSignalSpy occurrenceChanged(&model, &TimelineModel::occurrenceChanged);
+    const QModelIndex index = model.index(0, 2);
+    const QDateTime start = occurrence(2, 9).start;
+    QVERIFY(model.setData(index, start, KGantt::StartTimeRole));
+    QCOMPARE(occurrenceChanged.count(), 1);
+    QCOMPARE(occurrenceChanged.at(0).at(0).value<QModelIndex>(), index);
+    QCOMPARE(model.occurrence(index)->start, start);
+
+    QVERIFY(!model.setData(index, start, Qt::DisplayRole));
+    QVERIFY(!model.setData(model.index(0, 0), start, KGantt::StartTimeRole));
+    QCOMPARE(occurrenceChanged.count(), 1);
+
+    // The old times no longer count as shown, the new ones do
+    TimelineOccurrence moved = occurrence(2, 9);
+    moved.end = occurrence(2, 8).end;
+    model.appendOccurrences(0, {occurrence(2, 8), moved});
+    QCOMPARE(items(model, 0), QList<Akonadi::Item::Id>({1, 2, 2}));
+}
+
+/**
+ * Removing a row moves the rows below it up with their occurrences.
+ */
+void TimelineModelTest::removeCalendarRow()
+{
+    TimelineModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    for (int row = 0; row < 3; ++row) {
+        model.insertCalendarRow(row, {});
+        model.appendOccurrences(row, {occurrence(row + 1, 8), occurrence(row + 1, 9)});
+    }
+
+    model.removeCalendarRow(1);
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(items(model, 0), QList<Akonadi::Item::Id>({1, 1}));
+    QCOMPARE(items(model, 1), QList<Akonadi::Item::Id>({3, 3}));
+
+    model.removeCalendarRow(2);
+    QCOMPARE(model.rowCount(), 2);
+    model.removeCalendarRow(0);
+    QCOMPARE(items(model, 0), QList<Akonadi::Item::Id>({3, 3}));
+    QCOMPARE(model.columnCount(), 3);
+}
+
+/**
+ * Removing by UID takes the main incidence and its exceptions, which are
+ * other items, and leaves the rest of the row in order.
+ */
+void TimelineModelTest::removeByUid()
+{
+    TimelineModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    model.insertCalendarRow(0, {});
+    // Items 1 and 3 are an incidence and its exception
+    const QStringList uids = {QStringLiteral("a"), QStringLiteral("b"), QStringLiteral("a"), QStringLiteral("a"), QStringLiteral("c")};
+    QList<TimelineOccurrence> occurrences = {occurrence(1, 8), occurrence(2, 9), occurrence(3, 10), occurrence(1, 11), occurrence(4, 12)};
+    for (int i = 0; i < occurrences.size(); ++i) {
+        occurrences[i].uid = uids.at(i);
+    }
+    model.appendOccurrences(0, occurrences);
+
+    QSignalSpy dataChanged(&model, &QAbstractItemModel::dataChanged);
+    model.removeOccurrences(0, QStringLiteral("a"));
+    QCOMPARE(items(model, 0), QList<Akonadi::Item::Id>({2, 4}));
+    QCOMPARE(model.columnCount(), 6);
+    QCOMPARE(dataChanged.count(), 1);
+    QCOMPARE(dataChanged.at(0).at(0).value<QModelIndex>(), model.index(0, 1));
+    QCOMPARE(dataChanged.at(0).at(1).value<QModelIndex>(), model.index(0, 5));
+
+    // The removed items can be shown again
+    model.appendOccurrences(0, {occurrence(3, 10)});
+    QCOMPARE(items(model, 0), QList<Akonadi::Item::Id>({2, 4, 3}));
+
+    dataChanged.clear();
+    model.removeOccurrences(0, QStringLiteral("d"));
+    QCOMPARE(dataChanged.count(), 0);
+}
+}
+
+QTEST_MAIN(TimelineModelTest)
+
+#include "timelinemodeltest.moc"
@@ -7,146 +7,93 @@
 */
 
 #include "timelineitem.h"
+#include "timelinemodel.h"
 
 #include <Akonadi/CalendarUtils>
 
-#include <KGanttGlobal>
-
-#include <KCalUtils/IncidenceFormatter>
-
 using namespace KCalendarCore;
-using namespace KCalUtils;
 using namespace EventViews;
 
-TimelineItem::TimelineItem(const Akonadi::CollectionCalendar::Ptr &calendar, uint index, QStandardItemModel *model, QObject *parent)
+TimelineItem::TimelineItem(const Akonadi::CollectionCalendar::Ptr &calendar, uint index, TimelineModel *model, QObject *parent)
     : QObject(parent)
     , mCalendar(calendar)
     , mModel(model)
     , mIndex(index)
 {
-    mModel->removeRow(mIndex);
-    auto dummyItem = new QStandardItem;
-    dummyItem->setData(KGantt::TypeTask, KGantt::ItemTypeRole);
-    mModel->insertRow(mIndex, dummyItem);
+    mModel->insertCalendarRow(mIndex, mCalendar);
 }
 
-TimelineItem::~TimelineItem()
-{
-    mModel->removeRow(mIndex);
-}
+TimelineItem::~TimelineItem() = default;
 
 void TimelineItem::insertIncidence(const Akonadi::Item &item, const QDateTime &start, const QDateTime &end)
 {
-    const Incidence::Ptr incidence = Akonadi::CalendarUtils::incidence(item);
-    QDateTime dtStart(start);
-    QDateTime dtEnd(end);
-    if (!dtStart.isValid()) {
-        dtStart = incidence->dtStart().toLocalTime();
-    }
-    if (!dtEnd.isValid()) {
-        dtEnd = incidence->dateTime(Incidence::RoleEnd).toLocalTime();
-    }
-    if (incidence->allDay()) {
-        dtEnd = dtEnd.addDays(1);
-    }
-
-    using ItemList = QList<QStandardItem *>;
-    ItemList list = mItemMap.value(item.id());
-    for (ItemList::ConstIterator it = list.constBegin(); it != list.constEnd(); ++it) {
-        if (static_cast<TimelineSubItem *>(*it)->startTime() == dtStart && static_cast<TimelineSubItem *>(*it)->endTime() == dtEnd) {
-            return;
-        }
-    }
-
-    auto subItem = new TimelineSubItem(item, this);
-
-    subItem->setStartTime(dtStart);
-    subItem->setOriginalStart(dtStart);
-    subItem->setEndTime(dtEnd);
-    subItem->setData(mColor, Qt::DecorationRole);
-
-    list = mModel->takeRow(mIndex);
-
-    mItemMap[item.id()].append(subItem);
-
-    list.append(mItemMap[item.id()]);
-
-    mModel->insertRow(mIndex, list);
+    insertIncidences({{item, start, end}});
 }
 
-void TimelineItem::removeIncidence(const Akonadi::Item &item)
+void TimelineItem::insertIncidences(const QList<Occurrence> &occurrences)
 {
-    qDeleteAll(mItemMap.value(item.id()));
-    mItemMap.remove(item.id());
-}
+    QList<TimelineOccurrence> timelineOccurrences;
+    timelineOccurrences.reserve(occurrences.size());
+    for (const Occurrence &occurrence : occurrences) {
+        const Incidence::Ptr incidence = Akonadi::CalendarUtils::incidence(occurrence.item);
+        QDateTime dtStart(occurrence.start);
+        QDateTime dtEnd(occurrence.end);
+        if (!dtStart.isValid()) {
+            dtStart = incidence->dtStart().toLocalTime();
+        }
+        if (!dtEnd.isValid()) {
+            dtEnd = incidence->dateTime(Incidence::RoleEnd).toLocalTime();
+        }
+        if (incidence->allDay()) {
+            dtEnd = dtEnd.addDays(1);
+        }
 
-void TimelineItem::moveItems(const Akonadi::Item &item, int delta, int duration)
-{
-    using ItemList = QList<QStandardItem *>;
-    const ItemList list = mItemMap.value(item.id());
-    const ItemList::ConstIterator end(list.constEnd());
-    for (ItemList::ConstIterator it = list.constBegin(); it != end; ++it) {
-        QDateTime start = static_cast<TimelineSubItem *>(*it)->originalStart();
-        start = start.addSecs(delta);
-        static_cast<TimelineSubItem *>(*it)->setStartTime(start);
-        static_cast<TimelineSubItem *>(*it)->setOriginalStart(start);
-        static_cast<TimelineSubItem *>(*it)->setEndTime(start.addSecs(duration));
+        TimelineOccurrence timelineOccurrence;
+        timelineOccurrence.item = occurrence.item;
+        timelineOccurrence.uid = incidence->uid();
+        timelineOccurrence.originalStart = dtStart;
+        timelineOccurrence.start = dtStart;
+        timelineOccurrence.end = dtEnd;
+        timelineOccurrence.readOnly = incidence->isReadOnly();
+        timelineOccurrences.append(timelineOccurrence);
     }
-}
 
-void TimelineItem::setColor(const QColor &color)
-{
-    mColor = color;
+    mModel->appendOccurrences(mIndex, timelineOccurrences);
 }
 
-Akonadi::CollectionCalendar::Ptr TimelineItem::calendar() const
+void TimelineItem::removeIncidence(const Akonadi::Item &item)
 {
-    return mCalendar;
+    mModel->removeOccurrences(mIndex, item);
 }
 
-TimelineSubItem::TimelineSubItem(const Akonadi::Item &incidence, TimelineItem *parent)
-    : mIncidence(incidence)
-    , mParent(parent)
-    , mToolTipNeedsUpdate(true)
+void TimelineItem::removeIncidences(const QString &uid)
 {
-    setData(KGantt::TypeTask, KGantt::ItemTypeRole);
-    if (!Akonadi::CalendarUtils::incidence(incidence)->isReadOnly()) {
-        setFlags(Qt::ItemIsSelectable);
-    }
+    mModel->removeOccurrences(mIndex, uid);
 }
 
-TimelineSubItem::~TimelineSubItem() = default;
-
-void TimelineSubItem::setStartTime(const QDateTime &dt)
+void TimelineItem::moveItems(const Akonadi::Item &item, int delta, int duration)
 {
-    setData(dt, KGantt::StartTimeRole);
+    mModel->moveOccurrences(mIndex, item, delta, duration);
 }
 
-QDateTime TimelineSubItem::startTime() const
+void TimelineItem::setColor(const QColor &color)
 {
-    return data(KGantt::StartTimeRole).toDateTime();
+    mModel->setRowColor(mIndex, color);
 }
 
-void TimelineSubItem::setEndTime(const QDateTime &dt)
+Akonadi::CollectionCalendar::Ptr TimelineItem::calendar() const
 {
-    setData(dt, KGantt::EndTimeRole);
+    return mCalendar;
 }
 
-QDateTime TimelineSubItem::endTime() const
+uint TimelineItem::index() const
 {
-    return data(KGantt::EndTimeRole).toDateTime();
+    return mIndex;
 }
 
-void TimelineSubItem::updateToolTip()
+void TimelineItem::setIndex(uint index)
 {
-    if (!mToolTipNeedsUpdate) {
-        return;
-    }
-
-    mToolTipNeedsUpdate = false;
-
-    const auto name = Akonadi::CalendarUtils::displayName(mParent->calendar()->model(), mIncidence.parentCollection());
-    setData(IncidenceFormatter::toolTipStr(name, Akonadi::CalendarUtils::incidence(mIncidence), originalStart().date(), true), Qt::ToolTipRole);
+    mIndex = index;
 }
 
 #include "moc_timelineitem.cpp"
@@ -13,77 +13,62 @@
 #include <Akonadi/CollectionCalendar>
 #include <Akonadi/Item>
 
+#include <QColor>
 #include <QDateTime>
 #include <QList>
-#include <QMap>
-#include <QStandardItemModel>
+#include <QObject>
 
 namespace EventViews
 {
-class TimelineSubItem;
+class TimelineModel;
 
 class TimelineItem : public QObject
 {
     Q_OBJECT
 public:
-    TimelineItem(const Akonadi::CollectionCalendar::Ptr &calendar, uint index, QStandardItemModel *model, QObject *parent);
+    TimelineItem(const Akonadi::CollectionCalendar::Ptr &calendar, uint index, TimelineModel *model, QObject *parent);
     ~TimelineItem() override;
 
+    struct Occurrence {
+        Akonadi::Item item;
+        QDateTime start; // the start of the incidence if invalid
+        QDateTime end; // the end of the incidence if invalid
+    };
+
     void insertIncidence(const Akonadi::Item &item, const QDateTime &start = QDateTime(), const QDateTime &end = QDateTime());
+
+    /**
+     * Inserts all @p occurrences with a single change of the row,
+     * skipping the ones already shown.
+     */
+    void insertIncidences(const QList<Occurrence> &occurrences);
+
     void removeIncidence(const Akonadi::Item &item);
 
+    /**
+     * Removes the occurrences of all incidences with @p uid, exceptions included.
+     */
+    void removeIncidences(const QString &uid);
+
     void moveItems(const Akonadi::Item &item, int delta, int duration);
 
     void setColor(const QColor &color);
 
     [[nodiscard]] Akonadi::CollectionCalendar::Ptr calendar() const;
 
-private:
-    Akonadi::CollectionCalendar::Ptr mCalendar;
-    QMap<Akonadi::Item::Id, QList<QStandardItem *>> mItemMap;
-    QStandardItemModel *const mModel;
-    QColor mColor;
-    const uint mIndex;
-};
+    /**
+     * Returns the row of the calendar in the model.
+     */
+    [[nodiscard]] uint index() const;
 
-class TimelineSubItem : public QStandardItem
-{
-public:
-    TimelineSubItem(const Akonadi::Item &incidence, TimelineItem *parent);
-    ~TimelineSubItem() override;
-
-    [[nodiscard]] Akonadi::Item incidence() const
-    {
-        return mIncidence;
-    }
-
-    [[nodiscard]] QDateTime originalStart() const
-    {
-        return mStart;
-    }
-
-    void setOriginalStart(const QDateTime &dt)
-    {
-        mStart = dt;
-    }
-
-    void setStartTime(const QDateTime &dt);
-    [[nodiscard]] QDateTime startTime() const;
-
-    void setEndTime(const QDateTime &dt);
-    [[nodiscard]] QDateTime endTime() const;
-
-    [[nodiscard]] TimelineItem *parentItem() const
-    {
-        return mParent;
-    }
-
-    void updateToolTip();
+    /**
+     * Sets the row of the calendar, once a row above it was removed.
+     */
+    void setIndex(uint index);
 
 private:
-    Akonadi::Item mIncidence;
-    QDateTime mStart;
-    TimelineItem *const mParent = nullptr;
-    bool mToolTipNeedsUpdate;
+    Akonadi::CollectionCalendar::Ptr mCalendar;
+    TimelineModel *const mModel;
+    uint mIndex;
 };
 }
@@ -0,0 +1,287 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM contributors <kde-pim@kde.org>
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "timelinemodel.h"
+
+#include <Akonadi/CalendarUtils>
+
+#include <KCalUtils/IncidenceFormatter>
+
+#include <KGanttGlobal>
+
+#include <algorithm>
+
+using namespace EventViews;
+
+static std::pair<qint64, qint64> occurrenceTimes(const TimelineOccurrence &occurrence)
+{
+    return {occurrence.start.toMSecsSinceEpoch(), occurrence.end.toMSecsSinceEpoch()};
+}
+
+TimelineModel::TimelineModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+TimelineModel::~TimelineModel() = default;
+
+int TimelineModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(mRows.size());
+}
+
+int TimelineModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : mColumnCount;
+}
+
+QVariant TimelineModel::data(const QModelIndex &index, int role) const
+{
+    if (!checkIndex(index, CheckIndexOption::IndexIsValid)) {
+        return {};
+    }
+
+    if (index.column() == 0) {
+        // The row item
+        return role == KGantt::ItemTypeRole ? QVariant(KGantt::TypeTask) : QVariant();
+    }
+
+    const TimelineOccurrence *occurrence = this->occurrence(index);
+    if (!occurrence) {
+        return {};
+    }
+    switch (role) {
+    case KGantt::ItemTypeRole:
+        return KGantt::TypeTask;
+    case KGantt::StartTimeRole:
+        return occurrence->start;
+    case KGantt::EndTimeRole:
+        return occurrence->end;
+    case Qt::DecorationRole:
+        return mRows[index.row()].color;
+    case Qt::ToolTipRole:
+        return occurrence->toolTip;
+    default:
+        return {};
+    }
+}
+
+bool TimelineModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    TimelineOccurrence *occurrence = occurrenceAt(index);
+    if (!occurrence || (role != KGantt::StartTimeRole && role != KGantt::EndTimeRole)) {
+        return false;
+    }
+
+    auto &times = mRows[index.row()].times[occurrence->item.id()];
+    times.remove(occurrenceTimes(*occurrence));
+    if (role == KGantt::StartTimeRole) {
+        occurrence->start = value.toDateTime();
+    } else {
+        occurrence->end = value.toDateTime();
+    }
+    times.insert(occurrenceTimes(*occurrence));
+
+    Q_EMIT dataChanged(index, index, {role});
+    Q_EMIT occurrenceChanged(index);
+    return true;
+}
+
+Qt::ItemFlags TimelineModel::flags(const QModelIndex &index) const
+{
+    // Same as QStandardItem's defaults, which the timeline used to be built from
+    const Qt::ItemFlags defaultFlags =
+        Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsEditable | Qt::ItemIsDragEnabled | Qt::ItemIsDropEnabled;
+    if (index.column() == 0) {
+        return defaultFlags;
+    }
+    const TimelineOccurrence *occurrence = this->occurrence(index);
+    if (!occurrence) {
+        return Qt::NoItemFlags;
+    }
+    return occurrence->readOnly ? defaultFlags : Qt::ItemIsSelectable;
+}
+
+void TimelineModel::clear()
+{
+    beginResetModel();
+    mRows.clear();
+    mColumnCount = 1;
+    endResetModel();
+}
+
+void TimelineModel::insertCalendarRow(int row, const Akonadi::CollectionCalendar::Ptr &calendar)
+{
+    row = std::clamp(row, 0, rowCount());
+    beginInsertRows({}, row, row);
+    CalendarRow calendarRow;
+    calendarRow.calendar = calendar;
+    mRows.insert(mRows.begin() + row, std::move(calendarRow));
+    endInsertRows();
+}
+
+void TimelineModel::removeCalendarRow(int row)
+{
+    if (row < 0 || row >= rowCount()) {
+        return;
+    }
+    beginRemoveRows({}, row, row);
+    mRows.erase(mRows.begin() + row);
+    endRemoveRows();
+}
+
+void TimelineModel::setRowColor(int row, const QColor &color)
+{
+    if (row < 0 || row >= rowCount()) {
+        return;
+    }
+    mRows[row].color = color;
+    const int count = static_cast<int>(mRows[row].occurrences.size());
+    if (count > 0) {
+        Q_EMIT dataChanged(index(row, 1), index(row, count), {Qt::DecorationRole});
+    }
+}
+
+void TimelineModel::appendOccurrences(int row, const QList<TimelineOccurrence> &occurrences)
+{
+    if (row < 0 || row >= rowCount()) {
+        return;
+    }
+    CalendarRow &calendarRow = mRows[row];
+    const int oldCount = static_cast<int>(calendarRow.occurrences.size());
+
+    std::vector<TimelineOccurrence> newOccurrences;
+    newOccurrences.reserve(occurrences.size());
+    for (const TimelineOccurrence &occurrence : occurrences) {
+        auto &times = calendarRow.times[occurrence.item.id()];
+        const auto key = occurrenceTimes(occurrence);
+        if (times.contains(key)) {
+            continue;
+        }
+        times.insert(key);
+        newOccurrences.push_back(occurrence);
+    }
+    if (newOccurrences.empty()) {
+        return;
+    }
+
+    const int newCount = oldCount + static_cast<int>(newOccurrences.size());
+    const bool newColumns = newCount + 1 > mColumnCount;
+    if (newColumns) {
+        beginInsertColumns({}, mColumnCount, newCount);
+    }
+    calendarRow.occurrences.insert(calendarRow.occurrences.end(),
+                                   std::make_move_iterator(newOccurrences.begin()),
+                                   std::make_move_iterator(newOccurrences.end()));
+    if (newColumns) {
+        mColumnCount = newCount + 1;
+        endInsertColumns();
+    }
+    Q_EMIT dataChanged(index(row, oldCount + 1), index(row, newCount));
+}
+
+void TimelineModel::removeOccurrences(int row, const Akonadi::Item &item)
+{
+    removeOccurrencesIf(row, [&item](const TimelineOccurrence &occurrence) {
+        return occurrence.item.id() == item.id();
+    });
+}
+
+void TimelineModel::removeOccurrences(int row, const QString &uid)
+{
+    removeOccurrencesIf(row, [&uid](const TimelineOccurrence &occurrence) {
+        return occurrence.uid == uid;
+    });
+}
+
+void TimelineModel::removeOccurrencesIf(int row, const std::function<bool(const TimelineOccurrence &)> &predicate)
+{
+    if (row < 0 || row >= rowCount()) {
+        return;
+    }
+    CalendarRow &calendarRow = mRows[row];
+    auto &occurrences = calendarRow.occurrences;
+
+    // One pass, the following occurrences move to the left and the last
+    // cells become empty
+    int firstColumn = 0;
+    const int lastColumn = static_cast<int>(occurrences.size());
+    auto kept = occurrences.begin();
+    for (auto it = occurrences.begin(); it != occurrences.end(); ++it) {
+        if (predicate(*it)) {
+            if (firstColumn == 0) {
+                firstColumn = static_cast<int>(it - occurrences.begin()) + 1;
+            }
+            calendarRow.times.remove(it->item.id());
+        } else {
+            if (kept != it) {
+                *kept = std::move(*it);
+            }
+            ++kept;
+        }
+    }
+    if (firstColumn == 0) {
+        return;
+    }
+    occurrences.erase(kept, occurrences.end());
+    Q_EMIT dataChanged(index(row, firstColumn), index(row, lastColumn));
+}
+
+void TimelineModel::moveOccurrences(int row, const Akonadi::Item &item, int delta, int duration)
+{
+    if (row < 0 || row >= rowCount()) {
+        return;
+    }
+    CalendarRow &calendarRow = mRows[row];
+    auto &times = calendarRow.times[item.id()];
+    times.clear();
+    for (int i = 0; i < static_cast<int>(calendarRow.occurrences.size()); ++i) {
+        TimelineOccurrence &occurrence = calendarRow.occurrences[i];
+        if (occurrence.item.id() != item.id()) {
+            continue;
+        }
+        const QDateTime start = occurrence.originalStart.addSecs(delta);
+        occurrence.start = start;
+        occurrence.originalStart = start;
+        occurrence.end = start.addSecs(duration);
+        times.insert(occurrenceTimes(occurrence));
+        const QModelIndex idx = index(row, i + 1);
+        Q_EMIT dataChanged(idx, idx, {KGantt::StartTimeRole, KGantt::EndTimeRole});
+    }
+}
+
+const TimelineOccurrence *TimelineModel::occurrence(const QModelIndex &index) const
+{
+    if (!index.isValid() || index.model() != this || index.column() < 1 || index.row() >= rowCount()) {
+        return nullptr;
+    }
+    const auto &occurrences = mRows[index.row()].occurrences;
+    if (index.column() > static_cast<int>(occurrences.size())) {
+        return nullptr;
+    }
+    return &occurrences[index.column() - 1];
+}
+
+TimelineOccurrence *TimelineModel::occurrenceAt(const QModelIndex &index)
+{
+    return const_cast<TimelineOccurrence *>(occurrence(index));
+}
+
+void TimelineModel::updateToolTip(const QModelIndex &index)
+{
+    TimelineOccurrence *occurrence = occurrenceAt(index);
+    if (!occurrence || !occurrence->toolTip.isEmpty()) {
+        return;
+    }
+
+    const auto &calendar = mRows[index.row()].calendar;
+    const auto name = calendar ? Akonadi::CalendarUtils::displayName(calendar->model(), occurrence->item.parentCollection()) : QString();
+    occurrence->toolTip =
+        KCalUtils::IncidenceFormatter::toolTipStr(name, Akonadi::CalendarUtils::incidence(occurrence->item), occurrence->originalStart.date(), true);
+    Q_EMIT dataChanged(index, index, {Qt::ToolTipRole});
+}
+
+#include "moc_timelinemodel.cpp"
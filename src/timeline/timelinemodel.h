@@ -0,0 +1,132 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM contributors <kde-pim@kde.org>
+
+  SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "eventviews_private_export.h"
+
+#include <Akonadi/CollectionCalendar>
+#include <Akonadi/Item>
+
+#include <QAbstractTableModel>
+#include <QColor>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QSet>
+
+#include <functional>
+#include <vector>
+
+namespace EventViews
+{
+/**
+ * One occurrence of an incidence, shown as a bar in the timeline.
+ */
+struct TimelineOccurrence {
+    Akonadi::Item item;
+    QString uid; // Of the incidence, so removing by UID doesn't go through the payloads
+    QDateTime originalStart;
+    QDateTime start;
+    QDateTime end;
+    QString toolTip; // Built on demand, see TimelineModel::updateToolTip()
+    bool readOnly = false;
+};
+
+/**
+ * Model of the timeline for KGantt.
+ *
+ * There is one row per calendar, whose first column is the row item and
+ * whose other columns are the occurrences shown in that row. The occurrences
+ * are kept in plain per-row vectors, so reading the bars while painting is a
+ * lookup rather than going through QStandardItems and QVariants.
+ */
+class EVENTVIEWS_TESTS_EXPORT TimelineModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    explicit TimelineModel(QObject *parent = nullptr);
+    ~TimelineModel() override;
+
+    [[nodiscard]] int rowCount(const QModelIndex &parent = {}) const override;
+    [[nodiscard]] int columnCount(const QModelIndex &parent = {}) const override;
+    [[nodiscard]] QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    [[nodiscard]] Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+    /**
+     * Removes all rows.
+     */
+    void clear();
+
+    /**
+     * Inserts an empty row for @p calendar at @p row.
+     */
+    void insertCalendarRow(int row, const Akonadi::CollectionCalendar::Ptr &calendar);
+
+    /**
+     * Removes @p row and its occurrences, the rows below it move up.
+     */
+    void removeCalendarRow(int row);
+
+    void setRowColor(int row, const QColor &color);
+
+    /**
+     * Appends @p occurrences to @p row, skipping the ones already shown
+     * with the same start and end.
+     */
+    void appendOccurrences(int row, const QList<TimelineOccurrence> &occurrences);
+
+    /**
+     * Removes all occurrences of @p item from @p row.
+     */
+    void removeOccurrences(int row, const Akonadi::Item &item);
+
+    /**
+     * Removes all occurrences of the incidences with @p uid from @p row,
+     * exceptions included.
+     */
+    void removeOccurrences(int row, const QString &uid);
+
+    /**
+     * Moves all occurrences of @p item in @p row by @p delta seconds
+     * and gives them a length of @p duration seconds.
+     */
+    void moveOccurrences(int row, const Akonadi::Item &item, int delta, int duration);
+
+    /**
+     * Returns the occurrence at @p index, or nullptr if it's not one.
+     */
+    [[nodiscard]] const TimelineOccurrence *occurrence(const QModelIndex &index) const;
+
+    /**
+     * Builds the tool tip of the occurrence at @p index if it isn't yet.
+     */
+    void updateToolTip(const QModelIndex &index);
+
+Q_SIGNALS:
+    /**
+     * Emitted when the start or end of an occurrence was changed from the view.
+     */
+    void occurrenceChanged(const QModelIndex &index);
+
+private:
+    struct CalendarRow {
+        Akonadi::CollectionCalendar::Ptr calendar;
+        QColor color;
+        std::vector<TimelineOccurrence> occurrences;
+        QHash<Akonadi::Item::Id, QSet<std::pair<qint64, qint64>>> times; // start and end of the occurrences
+    };
+
+    [[nodiscard]] TimelineOccurrence *occurrenceAt(const QModelIndex &index);
+    void removeOccurrencesIf(int row, const std::function<bool(const TimelineOccurrence &)> &predicate);
+
+    std::vector<CalendarRow> mRows;
+    // Only grows until clear(), so when occurrences are removed the last
+    // columns of their row stay behind as empty cells
+    int mColumnCount = 1;
+};
+}
@@ -7,8 +7,8 @@
 */
 
 #include "timelineview.h"
-#include "helper.h"
 #include "timelineitem.h"
+#include "timelinemodel.h"
 #include "timelineview_p.h"
 
 #include <KGanttAbstractRowController>
@@ -18,7 +18,6 @@
 #include <KGanttItemDelegate>
 #include <KGanttStyleOptionGanttItem>
 
-#include <Akonadi/CalendarUtils>
 #include <Akonadi/IncidenceChanger>
 #include <CalendarSupport/CollectionSelection>
 
@@ -31,7 +30,6 @@
 #include <QPainter>
 #include <QPointer>
 #include <QSplitter>
-#include <QStandardItemModel>
 #include <QTreeWidget>
 #include <QVBoxLayout>
 
@@ -234,7 +232,8 @@ TimelineView::TimelineView(QWidget *parent)
     splitter->addWidget(d->mLeftView);
     splitter->addWidget(d->mGantt);
     splitter->setSizes({200, 600});
-    auto model = new QStandardItemModel(this);
+    auto model = new TimelineModel(this);
+    d->mModel = model;
 
     d->mRowController = new RowController;
 
@@ -258,7 +257,7 @@ TimelineView::TimelineView(QWidget *parent)
 
     vbox->addWidget(splitter);
 
-    connect(model, &QStandardItemModel::itemChanged, d.get(), &TimelineViewPrivate::itemChanged);
+    connect(model, &TimelineModel::occurrenceChanged, d.get(), &TimelineViewPrivate::itemChanged);
 
     connect(d->mGantt, &KGantt::GraphicsView::activated, d.get(), &TimelineViewPrivate::itemSelected);
     d->mGantt->setContextMenuPolicy(Qt::CustomContextMenu);
@@ -267,9 +266,35 @@ TimelineView::TimelineView(QWidget *parent)
 
 TimelineView::~TimelineView()
 {
+    for (const auto &calendar : calendars()) {
+        calendar->unregisterObserver(d.get());
+    }
     delete d->mRowController;
 }
 
+void TimelineView::addCalendar(const Akonadi::CollectionCalendar::Ptr &calendar)
+{
+    if (calendar && calendar->collection().isValid()) {
+        EventView::addCalendar(calendar);
+        calendar->registerObserver(d.get());
+
+        // A new row at the bottom, the other rows are kept
+        if (d->mStartDate.isValid() && d->mEndDate.isValid() && !d->mCalendarItemMap.contains(calendar->collection().id())) {
+            d->addCalendarItem(calendar);
+            d->insertCalendarIncidences(calendar);
+        }
+    }
+}
+
+void TimelineView::removeCalendar(const Akonadi::CollectionCalendar::Ptr &calendar)
+{
+    if (calendar && calendar->collection().isValid()) {
+        EventView::removeCalendar(calendar);
+        calendar->unregisterObserver(d.get());
+        d->removeCalendarItem(calendar->collection().id());
+    }
+}
+
 Akonadi::Item::List TimelineView::selectedIncidences() const
 {
     return d->mSelectedItemList;
@@ -304,20 +329,11 @@ void TimelineView::showDates(const QDate &start, const QDate &end, const QDate &
     d->mLeftView->clear();
     qDeleteAll(d->mCalendarItemMap);
     d->mCalendarItemMap.clear();
+    d->mModel->clear();
 
-    uint index = 0;
     const auto cals = calendars();
     for (const auto &calendar : cals) {
-        auto item = new TimelineItem(calendar, index++, static_cast<QStandardItemModel *>(d->mGantt->model()), d->mGantt);
-        const auto name = Akonadi::CalendarUtils::displayName(calendar->model(), calendar->collection());
-        d->mLeftView->addTopLevelItem(new QTreeWidgetItem(QStringList{name}));
-        const QColor resourceColor = EventViews::resourceColor(calendar->collection(), preferences());
-        if (resourceColor.isValid()) {
-            item->setColor(resourceColor);
-        }
-        qCDebug(CALENDARVIEW_LOG) << "Created item " << item << " (" << name << ")"
-                                  << "with index " << index - 1 << " from collection " << calendar->collection().id();
-        d->mCalendarItemMap.insert(calendar->collection().id(), item);
+        d->addCalendarItem(calendar);
     }
 
     // add incidences
@@ -331,16 +347,7 @@ void TimelineView::showDates(const QDate &start, const QDate &end, const QDate &
     d->mGantt->setModel(nullptr);
 
     for (const auto &calendar : cals) {
-        for (QDate day = d->mStartDate; day <= d->mEndDate; day = day.addDays(1)) {
-            const auto events = calendar->events(day, QTimeZone::systemTimeZone(), KCalendarCore::EventSortStartDate, KCalendarCore::SortDirectionAscending);
-            for (const KCalendarCore::Event::Ptr &event : std::as_const(events)) {
-                if (event->hasRecurrenceId()) {
-                    continue;
-                }
-                const Akonadi::Item item = calendar->item(event);
-                d->insertIncidence(calendar, item, day);
-            }
-        }
+        d->insertCalendarIncidences(calendar);
     }
     d->mGantt->setModel(ganttModel);
 }
@@ -360,20 +367,14 @@ void TimelineView::updateView()
 
 void TimelineView::changeIncidenceDisplay(const Akonadi::Item &item, int mode)
 {
-    const auto cal = calendar3(item);
-    if (!cal) {
+    if (!calendar3(item)) {
         return;
     }
     switch (mode) {
     case Akonadi::IncidenceChanger::ChangeTypeCreate:
-        d->insertIncidence(cal, item);
-        break;
     case Akonadi::IncidenceChanger::ChangeTypeModify:
-        d->removeIncidence(item);
-        d->insertIncidence(cal, item);
-        break;
     case Akonadi::IncidenceChanger::ChangeTypeDelete:
-        d->removeIncidence(item);
+        // Already applied when the calendar notified its observers
         break;
     default:
         updateView();
@@ -419,15 +420,9 @@ bool TimelineView::eventFilter(QObject *object, QEvent *event)
         if (item) {
             if (item->type() == KGantt::GraphicsItem::Type) {
                 auto graphicsItem = static_cast<KGantt::GraphicsItem *>(item);
+                // KGantt's proxy model has the same rows and columns
                 const QModelIndex itemIndex = graphicsItem->index();
-
-                auto itemModel = qobject_cast<QStandardItemModel *>(d->mGantt->model());
-
-                auto timelineItem = dynamic_cast<TimelineSubItem *>(itemModel->item(itemIndex.row(), itemIndex.column()));
-
-                if (timelineItem) {
-                    timelineItem->updateToolTip();
-                }
+                d->mModel->updateToolTip(d->mModel->index(itemIndex.row(), itemIndex.column()));
             }
         }
     }
@@ -46,6 +46,13 @@ public:
      */
     ~TimelineView() override;
 
+    /*!
+     */
+    void addCalendar(const Akonadi::CollectionCalendar::Ptr &calendar) override;
+    /*!
+     */
+    void removeCalendar(const Akonadi::CollectionCalendar::Ptr &calendar) override;
+
     /*!
      */
     [[nodiscard]] Akonadi::Item::List selectedIncidences() const override;
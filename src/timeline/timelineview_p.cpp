@@ -7,7 +7,9 @@
 */
 
 #include "timelineview_p.h"
+#include "helper.h"
 #include "timelineitem.h"
+#include "timelinemodel.h"
 
 #include <KGanttGraphicsView>
 
@@ -18,7 +20,7 @@
 
 #include "calendarview_debug.h"
 
-#include <QStandardItemModel>
+#include <QTreeWidget>
 
 using namespace KCalendarCore;
 using namespace EventViews;
@@ -30,19 +32,25 @@ TimelineViewPrivate::TimelineViewPrivate(TimelineView *parent)
 
 TimelineViewPrivate::~TimelineViewPrivate() = default;
 
+const TimelineOccurrence *TimelineViewPrivate::occurrenceAt(const QModelIndex &index) const
+{
+    // KGantt hands out indexes of its proxy model, which has the same rows and columns
+    return mModel->occurrence(mModel->index(index.row(), index.column()));
+}
+
 void TimelineViewPrivate::itemSelected(const QModelIndex &index)
 {
-    auto tlitem = dynamic_cast<TimelineSubItem *>(static_cast<QStandardItemModel *>(mGantt->model())->item(index.row(), index.column()));
-    if (tlitem) {
-        Q_EMIT q->incidenceSelected(tlitem->incidence(), tlitem->originalStart().date());
+    const TimelineOccurrence *occurrence = occurrenceAt(index);
+    if (occurrence) {
+        Q_EMIT q->incidenceSelected(occurrence->item, occurrence->originalStart.date());
     }
 }
 
 void TimelineViewPrivate::itemDoubleClicked(const QModelIndex &index)
 {
-    auto tlitem = dynamic_cast<TimelineSubItem *>(static_cast<QStandardItemModel *>(mGantt->model())->item(index.row(), index.column()));
-    if (tlitem) {
-        Q_EMIT q->editIncidenceSignal(tlitem->incidence());
+    const TimelineOccurrence *occurrence = occurrenceAt(index);
+    if (occurrence) {
+        Q_EMIT q->editIncidenceSignal(occurrence->item);
     }
 }
 
@@ -50,16 +58,17 @@ void TimelineViewPrivate::contextMenuRequested(QPoint point)
 {
     const QPersistentModelIndex index = mGantt->indexAt(point);
     // mHintDate = QDateTime( mGantt->getDateTimeForCoordX( QCursor::pos().x(), true ) );
-    auto tlitem = dynamic_cast<TimelineSubItem *>(static_cast<QStandardItemModel *>(mGantt->model())->item(index.row(), index.column()));
-    if (!tlitem) {
+    const TimelineOccurrence *occurrence = occurrenceAt(index);
+    if (!occurrence) {
         Q_EMIT q->showNewEventPopupSignal();
         mSelectedItemList = Akonadi::Item::List();
     } else {
-        if (const auto calendar = tlitem->parentItem()->calendar(); calendar) {
-            Q_EMIT q->showIncidencePopupSignal(calendar, tlitem->incidence(), Akonadi::CalendarUtils::incidence(tlitem->incidence())->dtStart().date());
+        const TimelineItem *timelineItem = calendarItemForIncidence(occurrence->item);
+        if (const auto calendar = timelineItem ? timelineItem->calendar() : Akonadi::CollectionCalendar::Ptr(); calendar) {
+            Q_EMIT q->showIncidencePopupSignal(calendar, occurrence->item, Akonadi::CalendarUtils::incidence(occurrence->item)->dtStart().date());
         }
 
-        mSelectedItemList << tlitem->incidence();
+        mSelectedItemList << occurrence->item;
     }
 }
 
@@ -80,94 +89,168 @@ TimelineItem *TimelineViewPrivate::calendarItemForIncidence(const Akonadi::Item
     return *timelineItem;
 }
 
-void TimelineViewPrivate::insertIncidence(const Akonadi::CollectionCalendar::Ptr &calendar, const Akonadi::Item &item, QDate day)
+TimelineItem *TimelineViewPrivate::addCalendarItem(const Akonadi::CollectionCalendar::Ptr &calendar)
+{
+    const uint index = mCalendarItemMap.size();
+    auto item = new TimelineItem(calendar, index, mModel, mGantt);
+    const auto name = Akonadi::CalendarUtils::displayName(calendar->model(), calendar->collection());
+    mLeftView->addTopLevelItem(new QTreeWidgetItem(QStringList{name}));
+    const QColor resourceColor = EventViews::resourceColor(calendar->collection(), q->preferences());
+    if (resourceColor.isValid()) {
+        item->setColor(resourceColor);
+    }
+    qCDebug(CALENDARVIEW_LOG) << "Created item " << item << " (" << name << ")"
+                              << "with index " << index << " from collection " << calendar->collection().id();
+    mCalendarItemMap.insert(calendar->collection().id(), item);
+    return item;
+}
+
+void TimelineViewPrivate::removeCalendarItem(Akonadi::Collection::Id id)
+{
+    TimelineItem *item = mCalendarItemMap.take(id);
+    if (!item) {
+        return;
+    }
+
+    // The rows below it move up
+    const uint index = item->index();
+    delete mLeftView->takeTopLevelItem(static_cast<int>(index));
+    mModel->removeCalendarRow(static_cast<int>(index));
+    for (TimelineItem *timelineItem : std::as_const(mCalendarItemMap)) {
+        if (timelineItem->index() > index) {
+            timelineItem->setIndex(timelineItem->index() - 1);
+        }
+    }
+    delete item;
+}
+
+void TimelineViewPrivate::insertCalendarIncidences(const Akonadi::CollectionCalendar::Ptr &calendar)
+{
+    TimelineItem *timelineItem = mCalendarItemMap.value(calendar->collection().id());
+    if (!timelineItem) {
+        return;
+    }
+
+    // One pass over the occurrences of the whole range, rather than a query
+    // and an expansion of the recurrences for every day
+    QList<TimelineItem::Occurrence> occurrences;
+    KCalendarCore::OccurrenceIterator occurIter(*calendar, mStartDate.startOfDay(), mEndDate.endOfDay());
+    while (occurIter.hasNext()) {
+        occurIter.next();
+        const Incidence::Ptr incidence = occurIter.incidence();
+        if (incidence->type() != Incidence::TypeEvent) {
+            continue;
+        }
+        const QDateTime startOfOccurrence = occurIter.occurrenceStartDate();
+        const QDateTime endOfOccurrence = incidence->endDateForStart(startOfOccurrence);
+        occurrences.append({calendar->item(incidence), startOfOccurrence.toLocalTime(), endOfOccurrence.toLocalTime()});
+    }
+    timelineItem->insertIncidences(occurrences);
+}
+
+void TimelineViewPrivate::insertIncidence(const Akonadi::CollectionCalendar::Ptr &calendar, const Akonadi::Item &item)
 {
-    const Incidence::Ptr incidence = Akonadi::CalendarUtils::incidence(item);
+    const Event::Ptr event = Akonadi::CalendarUtils::event(item);
+    if (!event) {
+        return;
+    }
+
     TimelineItem *timelineItem = calendarItemForIncidence(item);
     if (!timelineItem) {
         qCWarning(CALENDARVIEW_LOG) << "Help! Something is really wrong here!";
         return;
     }
 
-    if (incidence->recurs()) {
-        KCalendarCore::OccurrenceIterator occurIter(*calendar, incidence, QDateTime(day, QTime(0, 0, 0)), QDateTime(day, QTime(23, 59, 59)));
+    // Only the occurrences of this event, the rest of the timeline is untouched
+    if (event->recurs()) {
+        QList<TimelineItem::Occurrence> occurrences;
+        KCalendarCore::OccurrenceIterator occurIter(*calendar, event, mStartDate.startOfDay(), mEndDate.endOfDay());
         while (occurIter.hasNext()) {
             occurIter.next();
             const Akonadi::Item akonadiItem = calendar->item(occurIter.incidence());
             const QDateTime startOfOccurrence = occurIter.occurrenceStartDate();
             const QDateTime endOfOccurrence = occurIter.incidence()->endDateForStart(startOfOccurrence);
-            timelineItem->insertIncidence(akonadiItem, startOfOccurrence.toLocalTime(), endOfOccurrence.toLocalTime());
+            occurrences.append({akonadiItem, startOfOccurrence.toLocalTime(), endOfOccurrence.toLocalTime()});
         }
-    } else {
-        if (incidence->dtStart().date() == day || incidence->dtStart().date() < mStartDate) {
-            timelineItem->insertIncidence(item);
+        timelineItem->insertIncidences(occurrences);
+    } else if (event->dtStart().toLocalTime().date() <= mEndDate && event->dtEnd().toLocalTime().date() >= mStartDate) {
+        timelineItem->insertIncidence(item);
+    }
+}
+
+TimelineItem *TimelineViewPrivate::calendarItem(const KCalendarCore::Calendar *calendar) const
+{
+    for (TimelineItem *timelineItem : std::as_const(mCalendarItemMap)) {
+        if (timelineItem->calendar().data() == calendar) {
+            return timelineItem;
         }
     }
+    return nullptr;
 }
 
-void TimelineViewPrivate::insertIncidence(const Akonadi::CollectionCalendar::Ptr &calendar, const Akonadi::Item &item)
+void TimelineViewPrivate::reevaluateIncidence(TimelineItem *timelineItem, const QString &uid, const Incidence::Ptr &incidence)
 {
-    const Event::Ptr event = Akonadi::CalendarUtils::event(item);
-    if (!event) {
-        return;
+    // The main incidence brings its exceptions along, so they are all replaced together
+    timelineItem->removeIncidences(uid);
+
+    const auto calendar = timelineItem->calendar();
+    if (const Incidence::Ptr mainIncidence = calendar->incidence(uid)) {
+        insertIncidence(calendar, calendar->item(mainIncidence));
+    } else if (incidence) {
+        // A disassociated occurrence whose main incidence is gone
+        insertIncidence(calendar, calendar->item(incidence));
     }
+}
 
-    if (event->recurs()) {
-        insertIncidence(calendar, item, QDate());
-    }
-
-    for (QDate day = mStartDate; day <= mEndDate; day = day.addDays(1)) {
-        const auto events = calendar->events(day, QTimeZone::systemTimeZone(), KCalendarCore::EventSortStartDate, KCalendarCore::SortDirectionAscending);
-        if (events.contains(event)) {
-            // PENDING(AKONADI_PORT) check if correct. also check the original if,
-            // was inside the for loop (unnecessarily)
-            for (const KCalendarCore::Event::Ptr &i : events) {
-                const Akonadi::Item aItem = calendar->item(i);
-                insertIncidence(calendar, aItem, day);
-            }
+void TimelineViewPrivate::calendarIncidenceAdded(const Incidence::Ptr &incidence)
+{
+    if (mUpdatingIncidence || !incidence || incidence->type() != Incidence::TypeEvent) {
+        return;
+    }
+    for (TimelineItem *timelineItem : std::as_const(mCalendarItemMap)) {
+        if (timelineItem->calendar()->incidence(incidence->uid(), incidence->recurrenceId()) == incidence) {
+            reevaluateIncidence(timelineItem, incidence->uid(), incidence);
+            return;
         }
     }
 }
 
-void TimelineViewPrivate::removeIncidence(const Akonadi::Item &item)
+void TimelineViewPrivate::calendarIncidenceChanged(const Incidence::Ptr &incidence)
 {
-    TimelineItem *timelineItem = calendarItemForIncidence(item);
-    if (timelineItem) {
-        timelineItem->removeIncidence(item);
-    } else {
-#ifdef AKONADI_PORT_DISABLED
-        // try harder, the incidence might already be removed from the resource
-        typedef QMap<QString, KOrg::TimelineItem *> M2_t;
-        typedef QMap<KCalendarCore::ResourceCalendar *, M2_t> M1_t;
-        for (M1_t::ConstIterator it1 = d->mCalendarItemMap.constBegin(); it1 != mCalendarItemMap.constEnd(); ++it1) {
-            for (M2_t::ConstIterator it2 = it1.value().constBegin(); it2 != it1.value().constEnd(); ++it2) {
-                if (it2.value()) {
-                    it2.value()->removeIncidence(item);
-                }
-            }
-        }
-#endif
+    calendarIncidenceAdded(incidence);
+}
+
+void TimelineViewPrivate::calendarIncidenceDeleted(const Incidence::Ptr &incidence, const KCalendarCore::Calendar *calendar)
+{
+    if (mUpdatingIncidence || !incidence || incidence->type() != Incidence::TypeEvent) {
+        return;
+    }
+    if (TimelineItem *timelineItem = calendarItem(calendar)) {
+        reevaluateIncidence(timelineItem, incidence->uid());
     }
 }
 
-void TimelineViewPrivate::itemChanged(QStandardItem *item)
+void TimelineViewPrivate::itemChanged(const QModelIndex &index)
 {
-    auto tlit = dynamic_cast<TimelineSubItem *>(item);
-    if (!tlit) {
+    const TimelineOccurrence *occurrence = mModel->occurrence(index);
+    if (!occurrence) {
         return;
     }
 
-    const Akonadi::Item i = tlit->incidence();
+    const Akonadi::Item i = occurrence->item;
     const Incidence::Ptr inc = Akonadi::CalendarUtils::incidence(i);
 
-    QDateTime newStart(tlit->startTime());
+    QDateTime newStart(occurrence->start);
     if (inc->allDay()) {
         newStart = QDateTime(newStart.date().startOfDay());
     }
 
-    const int delta = tlit->originalStart().secsTo(newStart);
+    const int delta = occurrence->originalStart.secsTo(newStart);
+    int duration = occurrence->start.secsTo(occurrence->end);
+
+    // The occurrences are moved below, the calendar notifications would move them twice
+    mUpdatingIncidence = true;
     inc->setDtStart(inc->dtStart().addSecs(delta));
-    int duration = tlit->startTime().secsTo(tlit->endTime());
     int allDayOffset = 0;
     if (inc->allDay()) {
         const int secsPerDay = 60 * 60 * 24;
@@ -180,8 +263,11 @@ void TimelineViewPrivate::itemChanged(QStandardItem *item)
         }
     }
     inc->setDuration(duration);
-    TimelineItem *parent = tlit->parentItem();
-    parent->moveItems(i, tlit->originalStart().secsTo(newStart), duration + allDayOffset);
+    mUpdatingIncidence = false;
+    TimelineItem *parent = calendarItemForIncidence(i);
+    if (parent) {
+        parent->moveItems(i, delta, duration + allDayOffset);
+    }
 }
 
 #include "moc_timelineview_p.cpp"
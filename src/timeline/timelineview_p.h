@@ -11,11 +11,12 @@
 #include <Akonadi/Collection>
 #include <Akonadi/Item>
 
+#include <KCalendarCore/Calendar>
+
 #include <QMap>
 #include <QModelIndex>
 #include <QObject>
 
-class QStandardItem;
 class QTreeWidget;
 
 namespace KGantt
@@ -26,9 +27,11 @@ class GraphicsView;
 namespace EventViews
 {
 class TimelineItem;
+class TimelineModel;
+struct TimelineOccurrence;
 class RowController;
 
-class TimelineViewPrivate : public QObject
+class TimelineViewPrivate : public QObject, public KCalendarCore::Calendar::CalendarObserver
 {
     Q_OBJECT
 public:
@@ -36,28 +39,43 @@ public:
     ~TimelineViewPrivate() override;
 
     TimelineItem *calendarItemForIncidence(const Akonadi::Item &item) const;
+    TimelineItem *addCalendarItem(const Akonadi::CollectionCalendar::Ptr &calendar);
+    void removeCalendarItem(Akonadi::Collection::Id id);
+    void insertCalendarIncidences(const Akonadi::CollectionCalendar::Ptr &calendar);
+    const TimelineOccurrence *occurrenceAt(const QModelIndex &index) const;
     void insertIncidence(const Akonadi::CollectionCalendar::Ptr &calendar, const Akonadi::Item &item);
-    void insertIncidence(const Akonadi::CollectionCalendar::Ptr &calendar, const Akonadi::Item &item, QDate day);
-    void removeIncidence(const Akonadi::Item &item);
+    TimelineItem *calendarItem(const KCalendarCore::Calendar *calendar) const;
+    void reevaluateIncidence(TimelineItem *timelineItem, const QString &uid, const KCalendarCore::Incidence::Ptr &incidence = {});
 
 public Q_SLOTS:
     // void overscale( KDGantt::View::Scale scale );
     void itemSelected(const QModelIndex &index);
     void itemDoubleClicked(const QModelIndex &index);
-    void itemChanged(QStandardItem *item);
+    void itemChanged(const QModelIndex &index);
     void contextMenuRequested(QPoint point);
     void newEventWithHint(const QDateTime &);
 
 public:
     Akonadi::Item::List mSelectedItemList;
     KGantt::GraphicsView *mGantt = nullptr;
+    TimelineModel *mModel = nullptr;
     QTreeWidget *mLeftView = nullptr;
     RowController *mRowController = nullptr;
     QMap<Akonadi::Collection::Id, TimelineItem *> mCalendarItemMap;
     QDate mStartDate, mEndDate;
     QDateTime mHintDate;
+    bool mUpdatingIncidence = false;
+
+protected:
+    /* reimplemented from KCalendarCore::Calendar::CalendarObserver */
+    void calendarIncidenceAdded(const KCalendarCore::Incidence::Ptr &incidence) override;
+    void calendarIncidenceChanged(const KCalendarCore::Incidence::Ptr &incidence) override;
+    void calendarIncidenceDeleted(const KCalendarCore::Incidence::Ptr &incidence, const KCalendarCore::Calendar *calendar) override;
 
 private:
+    // quiet --overloaded-virtual warning
+    using KCalendarCore::Calendar::CalendarObserver::calendarIncidenceDeleted;
+
     TimelineView *const q;
 };
 } // namespace EventViews
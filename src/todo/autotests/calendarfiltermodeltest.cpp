@@ -0,0 +1,325 @@
+/*
+ * SPDX-FileCopyrightText: 2026 KDE PIM contributors <kde-pim@kde.org>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <QTest>
+
+#include "../calendarfiltermodel.h"
+
+#include <Akonadi/EntityTreeModel>
+#include <Akonadi/Item>
+
+#include <QAbstractItemModelTester>
+
+using namespace EventViews;
+
+namespace
+{
+/**
+ * Two levels like the to-do model: collections with items and sub-collections.
+ * Children point to their collection by id, so they survive collection moves.
+ */
+class TreeModel : public QAbstractItemModel
+{
+public:
+    [[nodiscard]] QModelIndex index(int row, int column, const QModelIndex &parent = {}) const override
+    {
+        if (!hasIndex(row, column, parent)) {
+            return {};
+        }
+        return createIndex(row, column, parent.isValid() ? quintptr(mCollections[parent.row()].id) : quintptr(0));
+    }
+
+    [[nodiscard]] QModelIndex parent(const QModelIndex &child) const override
+    {
+        if (!child.isValid() || child.internalId() == 0) {
+            return {};
+        }
+        return createIndex(collectionRow(Akonadi::Collection::Id(child.internalId())), 0, quintptr(0));
+    }
+
+    [[nodiscard]] int rowCount(const QModelIndex &parent = {}) const override
+    {
+        if (!parent.isValid()) {
+            return mCollections.size();
+        }
+        if (parent.internalId() != 0 || parent.column() != 0) {
+            return 0;
+        }
+        return mCollections[parent.row()].children.size();
+    }
+
+    [[nodiscard]] int columnCount(const QModelIndex &parent = {}) const override
+    {
+        Q_UNUSED(parent)
+        return 1;
+    }
+
+    [[nodiscard]] QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override
+    {
+        if (!index.isValid()) {
+            return {};
+        }
+        if (index.internalId() == 0) {
+            return role == Akonadi::EntityTreeModel::CollectionIdRole ? QVariant(mCollections[index.row()].id) : QVariant();
+        }
+        const qint64 child = mCollections[collectionRow(Akonadi::Collection::Id(index.internalId()))].children[index.row()];
+        if (child < 0) {
+            return role == Akonadi::EntityTreeModel::CollectionIdRole ? QVariant(-child) : QVariant();
+        }
+        if (role == Akonadi::EntityTreeModel::ItemRole) {
+            return QVariant::fromValue(Akonadi::Item(child));
+        }
+        return role == Qt::DisplayRole ? QVariant(child) : QVariant();
+    }
+
+    void appendCollection(Akonadi::Collection::Id id, const QList<qint64> &children)
+    {
+        beginInsertRows({}, mCollections.size(), mCollections.size());
+        mCollections.append({id, children});
+        endInsertRows();
+    }
+
+    void removeCollection(int row)
+    {
+        beginRemoveRows({}, row, row);
+        mCollections.removeAt(row);
+        endRemoveRows();
+    }
+
+    void insertChildren(int collection, int row, const QList<qint64> &children)
+    {
+        beginInsertRows(index(collection, 0), row, row + children.size() - 1);
+        auto &list = mCollections[collection].children;
+        for (int i = 0; i < children.size(); ++i) {
+            list.insert(row + i, children[i]);
+        }
+        endInsertRows();
+    }
+
+    void removeChildren(int collection, int first, int last)
+    {
+        beginRemoveRows(index(collection, 0), first, last);
+        mCollections[collection].children.remove(first, last - first + 1);
+        endRemoveRows();
+    }
+
+    void moveChild(int collection, int row, int destinationCollection, int destinationRow)
+    {
+        QVERIFY(beginMoveRows(index(collection, 0), row, row, index(destinationCollection, 0), destinationRow));
+        const qint64 child = mCollections[collection].children.takeAt(row);
+        if (collection == destinationCollection && destinationRow > row) {
+            --destinationRow;
+        }
+        mCollections[destinationCollection].children.insert(destinationRow, child);
+        endMoveRows();
+    }
+
+private:
+    struct Collection {
+        Akonadi::Collection::Id id;
+        QList<qint64> children; // Item ids, sub-collections are negative collection ids
+    };
+
+    [[nodiscard]] int collectionRow(Akonadi::Collection::Id id) const
+    {
+        for (int i = 0; i < mCollections.size(); ++i) {
+            if (mCollections[i].id == id) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    QList<Collection> mCollections;
+};
+
+/**
+ * Looks collections up in any source model, not only in an entity tree model.
+ */
+class TestFilterModel : public CalendarFilterModel
+{
+protected:
+    [[nodiscard]] QModelIndex collectionIndex(Akonadi::Collection::Id id) const override
+    {
+        if (!sourceModel()) {
+            return {};
+        }
+        for (int row = 0; row < sourceModel()->rowCount(); ++row) {
+            const QModelIndex collection = sourceModel()->index(row, 0);
+            if (collection.data(Akonadi::EntityTreeModel::CollectionIdRole).toLongLong() == id) {
+                return collection;
+            }
+        }
+        return {};
+    }
+};
+
+class CalendarFilterModelTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void enableBeforeLoad();
+    void enableAfterLoad();
+    void insertAndRemoveItems();
+    void moveItems();
+    void removeCollectionRow();
+
+public:
+    [[nodiscard]] static QList<qint64> items(const CalendarFilterModel &model);
+};
+
+QList<qint64> CalendarFilterModelTest::items(const CalendarFilterModel &model)
+{
+    QList<qint64> ids;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        const QModelIndex index = model.index(row, 0);
+        const QModelIndex source = model.mapToSource(index);
+        // Every row maps back to itself
+        if (model.mapFromSource(source) != index) {
+            return {};
+        }
+        ids.append(source.data(Akonadi::EntityTreeModel::ItemRole).value<Akonadi::Item>().id());
+    }
+    return ids;
+}
+
+/**
+ * A calendar enabled before its collection is loaded shows up once it is.
+ */
+void CalendarFilterModelTest::enableBeforeLoad()
+{
+    TreeModel source;
+    TestFilterModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    model.setSourceModel(&source);
+
+    model.addCollection(1);
+    model.addCollection(2);
+    QCOMPARE(model.rowCount(), 0);
+
+    source.appendCollection(3, {30});
+    QCOMPARE(model.rowCount(), 0);
+    source.appendCollection(2, {20, -4, 21});
+    QCOMPARE(items(model), QList<qint64>({20, 21}));
+    source.appendCollection(1, {});
+    QCOMPARE(items(model), QList<qint64>({20, 21}));
+    source.insertChildren(2, 0, {10});
+    QCOMPARE(items(model), QList<qint64>({20, 21, 10}));
+}
+
+/**
+ * Enabling and disabling a loaded calendar inserts and removes its block of rows.
+ */
+void CalendarFilterModelTest::enableAfterLoad()
+{
+    TreeModel source;
+    source.appendCollection(1, {10, 11});
+    source.appendCollection(2, {});
+    source.appendCollection(3, {30, -5, 31, 32});
+    TestFilterModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    model.setSourceModel(&source);
+
+    model.addCollection(3);
+    model.addCollection(2);
+    model.addCollection(1);
+    QCOMPARE(items(model), QList<qint64>({30, 31, 32, 10, 11}));
+    model.addCollection(1);
+    QCOMPARE(model.rowCount(), 5);
+
+    model.removeCollection(3);
+    QCOMPARE(items(model), QList<qint64>({10, 11}));
+    model.removeCollection(2);
+    model.removeCollection(4);
+    QCOMPARE(items(model), QList<qint64>({10, 11}));
+    model.addCollection(3);
+    QCOMPARE(items(model), QList<qint64>({10, 11, 30, 31, 32}));
+    model.removeCollection(1);
+    QCOMPARE(items(model), QList<qint64>({30, 31, 32}));
+}
+
+/**
+ * Items inserted or removed in the middle of a calendar shift the later rows,
+ * sub-collections aren't listed.
+ */
+void CalendarFilterModelTest::insertAndRemoveItems()
+{
+    TreeModel source;
+    source.appendCollection(1, {10, 11});
+    source.appendCollection(2, {20, 21});
+    TestFilterModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    model.setSourceModel(&source);
+    model.addCollection(1);
+    model.addCollection(2);
+
+    source.insertChildren(0, 1, {12, -3, 13});
+    QCOMPARE(items(model), QList<qint64>({10, 12, 13, 11, 20, 21}));
+    source.insertChildren(1, 2, {22});
+    QCOMPARE(items(model), QList<qint64>({10, 12, 13, 11, 20, 21, 22}));
+
+    source.removeChildren(0, 0, 2);
+    QCOMPARE(items(model), QList<qint64>({13, 11, 20, 21, 22}));
+    source.removeChildren(0, 0, 0);
+    QCOMPARE(items(model), QList<qint64>({11, 20, 21, 22}));
+    source.removeChildren(1, 1, 2);
+    QCOMPARE(items(model), QList<qint64>({11, 20}));
+}
+
+/**
+ * Items moved within and between calendars end up at their new place.
+ */
+void CalendarFilterModelTest::moveItems()
+{
+    TreeModel source;
+    source.appendCollection(1, {10, 11, 12});
+    source.appendCollection(2, {20});
+    source.appendCollection(3, {30});
+    TestFilterModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    model.setSourceModel(&source);
+    model.addCollection(1);
+    model.addCollection(2);
+
+    source.moveChild(0, 0, 0, 3);
+    QCOMPARE(items(model), QList<qint64>({20, 11, 12, 10}));
+    source.moveChild(1, 0, 0, 1);
+    QCOMPARE(items(model), QList<qint64>({11, 20, 12, 10}));
+    source.moveChild(2, 0, 0, 0);
+    QCOMPARE(items(model), QList<qint64>({30, 11, 20, 12, 10}));
+    source.moveChild(0, 4, 2, 0);
+    QCOMPARE(items(model), QList<qint64>({30, 11, 20, 12}));
+}
+
+/**
+ * A calendar whose collection goes away stays enabled and comes back with it.
+ */
+void CalendarFilterModelTest::removeCollectionRow()
+{
+    TreeModel source;
+    source.appendCollection(1, {10});
+    source.appendCollection(2, {20, 21});
+    source.appendCollection(3, {30});
+    TestFilterModel model;
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    model.setSourceModel(&source);
+    model.addCollection(1);
+    model.addCollection(2);
+    model.addCollection(3);
+
+    source.removeCollection(1);
+    QCOMPARE(items(model), QList<qint64>({10, 30}));
+    source.insertChildren(1, 0, {31});
+    QCOMPARE(items(model), QList<qint64>({10, 31, 30}));
+    source.appendCollection(2, {22});
+    QCOMPARE(items(model), QList<qint64>({10, 31, 30, 22}));
+}
+}
+
+QTEST_MAIN(CalendarFilterModelTest)
+
+#include "calendarfiltermodeltest.moc"
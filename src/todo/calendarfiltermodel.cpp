@@ -0,0 +1,348 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM contributors <kde-pim@kde.org>
+
+  SPDX-License-Identifier: GPL-2.0-or-later WITH LicenseRef-Qt-Commercial-exception-1.0
+*/
+
+#include "calendarfiltermodel.h"
+
+#include <Akonadi/EntityTreeModel>
+#include <Akonadi/Item>
+
+#include <algorithm>
+
+using namespace EventViews;
+
+CalendarFilterModel::CalendarFilterModel(QObject *parent)
+    : QAbstractProxyModel(parent)
+{
+}
+
+CalendarFilterModel::~CalendarFilterModel() = default;
+
+void CalendarFilterModel::setSourceModel(QAbstractItemModel *model)
+{
+    beginResetModel();
+    for (const auto &connection : std::as_const(mSourceConnections)) {
+        disconnect(connection);
+    }
+    mSourceConnections.clear();
+
+    QAbstractProxyModel::setSourceModel(model);
+    if (model) {
+        mSourceConnections = {
+            connect(model, &QAbstractItemModel::rowsInserted, this, &CalendarFilterModel::sourceRowsInserted),
+            connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this, &CalendarFilterModel::sourceRowsAboutToBeRemoved),
+            connect(model, &QAbstractItemModel::rowsRemoved, this, &CalendarFilterModel::sourceRowsRemoved),
+            connect(model, &QAbstractItemModel::rowsAboutToBeMoved, this, &CalendarFilterModel::sourceRowsAboutToBeMoved),
+            connect(model, &QAbstractItemModel::rowsMoved, this, &CalendarFilterModel::attachCalendars),
+            connect(model, &QAbstractItemModel::dataChanged, this, &CalendarFilterModel::sourceDataChanged),
+            connect(model, &QAbstractItemModel::layoutAboutToBeChanged, this, &CalendarFilterModel::beginResetModel),
+            connect(model, &QAbstractItemModel::layoutChanged, this, &CalendarFilterModel::resetCalendars),
+            connect(model, &QAbstractItemModel::modelAboutToBeReset, this, &CalendarFilterModel::beginResetModel),
+            connect(model, &QAbstractItemModel::modelReset, this, &CalendarFilterModel::resetCalendars),
+        };
+    }
+
+    resetCalendars();
+}
+
+void CalendarFilterModel::addCollection(Akonadi::Collection::Id id)
+{
+    if (mEnabledCalendars.contains(id)) {
+        return;
+    }
+    mEnabledCalendars.insert(id);
+
+    // Otherwise it's added once the collection is loaded
+    const QModelIndex collection = collectionIndex(id);
+    if (collection.isValid()) {
+        insertCalendar(id, collection);
+    }
+}
+
+void CalendarFilterModel::removeCollection(Akonadi::Collection::Id id)
+{
+    if (!mEnabledCalendars.remove(id)) {
+        return;
+    }
+    for (int i = 0; i < static_cast<int>(mCalendars.size()); ++i) {
+        if (mCalendars[i].id == id) {
+            removeCalendarAt(i);
+            break;
+        }
+    }
+}
+
+QModelIndex CalendarFilterModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (parent.isValid() || row < 0 || row >= rowCount() || column < 0 || column >= columnCount()) {
+        return {};
+    }
+    return createIndex(row, column);
+}
+
+QModelIndex CalendarFilterModel::parent(const QModelIndex &child) const
+{
+    Q_UNUSED(child)
+    return {};
+}
+
+int CalendarFilterModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return mOffsets.back();
+}
+
+int CalendarFilterModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !sourceModel()) {
+        return 0;
+    }
+    return sourceModel()->columnCount();
+}
+
+QModelIndex CalendarFilterModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+    if (!proxyIndex.isValid() || proxyIndex.row() >= rowCount()) {
+        return {};
+    }
+    // The last calendar beginning at or before the row. Empty calendars
+    // begin where the next one does, so they are skipped.
+    const auto it = std::upper_bound(mOffsets.cbegin(), mOffsets.cend() - 1, proxyIndex.row()) - 1;
+    const auto &calendar = mCalendars[it - mOffsets.cbegin()];
+    return sourceModel()->index(calendar.itemRows[proxyIndex.row() - *it], proxyIndex.column(), calendar.collection);
+}
+
+QModelIndex CalendarFilterModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+    if (!sourceIndex.isValid()) {
+        return {};
+    }
+    const int i = calendarAt(sourceIndex.parent());
+    if (i < 0) {
+        return {};
+    }
+    const auto &rows = mCalendars[i].itemRows;
+    const auto it = std::lower_bound(rows.cbegin(), rows.cend(), sourceIndex.row());
+    if (it == rows.cend() || *it != sourceIndex.row()) {
+        return {};
+    }
+    return index(calendarOffset(i) + static_cast<int>(it - rows.cbegin()), sourceIndex.column());
+}
+
+QModelIndex CalendarFilterModel::collectionIndex(Akonadi::Collection::Id id) const
+{
+    if (!sourceModel()) {
+        return {};
+    }
+    return Akonadi::EntityTreeModel::modelIndexForCollection(sourceModel(), Akonadi::Collection(id));
+}
+
+QList<int> CalendarFilterModel::itemRows(const QModelIndex &collection, int first, int last) const
+{
+    QList<int> rows;
+    for (int row = first; row <= last; ++row) {
+        const auto item = sourceModel()->index(row, 0, collection).data(Akonadi::EntityTreeModel::ItemRole).value<Akonadi::Item>();
+        if (item.isValid()) {
+            rows.append(row);
+        }
+    }
+    return rows;
+}
+
+int CalendarFilterModel::calendarAt(const QModelIndex &collection) const
+{
+    if (!collection.isValid()) {
+        return -1;
+    }
+    for (int i = 0; i < static_cast<int>(mCalendars.size()); ++i) {
+        if (mCalendars[i].collection == collection) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int CalendarFilterModel::calendarOffset(int i) const
+{
+    return mOffsets[i];
+}
+
+void CalendarFilterModel::updateOffsets(int from)
+{
+    mOffsets.resize(mCalendars.size() + 1);
+    for (std::size_t i = from; i < mCalendars.size(); ++i) {
+        mOffsets[i + 1] = mOffsets[i] + static_cast<int>(mCalendars[i].itemRows.size());
+    }
+}
+
+void CalendarFilterModel::insertCalendar(Akonadi::Collection::Id id, const QModelIndex &collection)
+{
+    const QList<int> rows = itemRows(collection, 0, sourceModel()->rowCount(collection) - 1);
+    const int offset = rowCount();
+    const int i = static_cast<int>(mCalendars.size());
+    if (rows.isEmpty()) {
+        mCalendars.push_back({id, collection, rows});
+        updateOffsets(i);
+        return;
+    }
+    beginInsertRows({}, offset, offset + rows.size() - 1);
+    mCalendars.push_back({id, collection, rows});
+    updateOffsets(i);
+    endInsertRows();
+}
+
+void CalendarFilterModel::removeCalendarAt(int i)
+{
+    const int count = mCalendars[i].itemRows.size();
+    if (count == 0) {
+        mCalendars.erase(mCalendars.begin() + i);
+        updateOffsets(i);
+        return;
+    }
+    const int offset = calendarOffset(i);
+    beginRemoveRows({}, offset, offset + count - 1);
+    mCalendars.erase(mCalendars.begin() + i);
+    updateOffsets(i);
+    endRemoveRows();
+}
+
+void CalendarFilterModel::attachCalendars()
+{
+    for (const auto id : std::as_const(mEnabledCalendars)) {
+        const bool attached = std::any_of(mCalendars.cbegin(), mCalendars.cend(), [id](const CalendarRows &calendar) {
+            return calendar.id == id;
+        });
+        if (attached) {
+            continue;
+        }
+        const QModelIndex collection = collectionIndex(id);
+        if (collection.isValid()) {
+            insertCalendar(id, collection);
+        }
+    }
+}
+
+// Ends the reset begun by the caller
+void CalendarFilterModel::resetCalendars()
+{
+    mCalendars.clear();
+    if (sourceModel()) {
+        for (const auto id : std::as_const(mEnabledCalendars)) {
+            const QModelIndex collection = collectionIndex(id);
+            if (collection.isValid()) {
+                mCalendars.push_back({id, collection, itemRows(collection, 0, sourceModel()->rowCount(collection) - 1)});
+            }
+        }
+    }
+    updateOffsets(0);
+    endResetModel();
+}
+
+void CalendarFilterModel::sourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    const int i = calendarAt(parent);
+    const QList<int> newRows = i >= 0 ? itemRows(parent, first, last) : QList<int>();
+    if (i >= 0) {
+        auto &rows = mCalendars[i].itemRows;
+        const auto pos = static_cast<int>(std::lower_bound(rows.begin(), rows.end(), first) - rows.begin());
+        const int count = last - first + 1;
+        for (int j = pos; j < rows.size(); ++j) {
+            rows[j] += count;
+        }
+        if (!newRows.isEmpty()) {
+            const int offset = calendarOffset(i) + pos;
+            beginInsertRows({}, offset, offset + newRows.size() - 1);
+            rows.insert(pos, newRows.size(), 0);
+            std::copy(newRows.cbegin(), newRows.cend(), rows.begin() + pos);
+            updateOffsets(i);
+            endInsertRows();
+        }
+    }
+
+    // Collections were inserted, maybe one of the enabled calendars
+    if (i < 0 || newRows.size() < last - first + 1) {
+        attachCalendars();
+    }
+}
+
+void CalendarFilterModel::sourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    // Calendars going away, together with one of their ancestors
+    for (int i = static_cast<int>(mCalendars.size()) - 1; i >= 0; --i) {
+        for (QModelIndex ancestor = mCalendars[i].collection; ancestor.isValid(); ancestor = ancestor.parent()) {
+            if (ancestor.parent() == parent && ancestor.row() >= first && ancestor.row() <= last) {
+                removeCalendarAt(i);
+                break;
+            }
+        }
+    }
+
+    const int i = calendarAt(parent);
+    if (i < 0) {
+        return;
+    }
+    auto &rows = mCalendars[i].itemRows;
+    const auto begin = std::lower_bound(rows.begin(), rows.end(), first);
+    const auto end = std::lower_bound(begin, rows.end(), last + 1);
+    if (begin == end) {
+        return;
+    }
+    // The rows after the removed ones are shifted once the source has removed them
+    const int offset = calendarOffset(i) + static_cast<int>(begin - rows.begin());
+    beginRemoveRows({}, offset, offset + static_cast<int>(end - begin) - 1);
+    rows.erase(begin, end);
+    updateOffsets(i);
+    mRemovingRows = true;
+}
+
+void CalendarFilterModel::sourceRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    const int i = calendarAt(parent);
+    if (i >= 0) {
+        auto &rows = mCalendars[i].itemRows;
+        const int count = last - first + 1;
+        for (auto it = std::lower_bound(rows.begin(), rows.end(), first); it != rows.end(); ++it) {
+            *it -= count;
+        }
+    }
+    if (mRemovingRows) {
+        mRemovingRows = false;
+        endRemoveRows();
+    }
+}
+
+void CalendarFilterModel::sourceRowsAboutToBeMoved(const QModelIndex &sourceParent, int first, int last, const QModelIndex &destinationParent)
+{
+    Q_UNUSED(first)
+    Q_UNUSED(last)
+    // Rare, so the calendars involved are detached and attached again once moved
+    for (int i = static_cast<int>(mCalendars.size()) - 1; i >= 0; --i) {
+        if (mCalendars[i].collection == sourceParent || mCalendars[i].collection == destinationParent) {
+            removeCalendarAt(i);
+        }
+    }
+}
+
+void CalendarFilterModel::sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles)
+{
+    const int i = calendarAt(topLeft.parent());
+    if (i < 0) {
+        return;
+    }
+    const auto &rows = mCalendars[i].itemRows;
+    const auto begin = std::lower_bound(rows.cbegin(), rows.cend(), topLeft.row());
+    const auto end = std::lower_bound(begin, rows.cend(), bottomRight.row() + 1);
+    if (begin == end) {
+        return;
+    }
+    const int offset = calendarOffset(i);
+    Q_EMIT dataChanged(index(offset + static_cast<int>(begin - rows.cbegin()), topLeft.column()),
+                       index(offset + static_cast<int>(end - rows.cbegin()) - 1, bottomRight.column()),
+                       roles);
+}
+
+#include "moc_calendarfiltermodel.cpp"
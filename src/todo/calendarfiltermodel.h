@@ -0,0 +1,90 @@
+/*
+  SPDX-FileCopyrightText: 2026 KDE PIM contributors <kde-pim@kde.org>
+
+  SPDX-License-Identifier: GPL-2.0-or-later WITH LicenseRef-Qt-Commercial-exception-1.0
+*/
+
+#pragma once
+
+#include "eventviews_private_export.h"
+
+#include <Akonadi/Collection>
+
+#include <QAbstractProxyModel>
+#include <QPersistentModelIndex>
+#include <QSet>
+
+#include <vector>
+
+namespace EventViews
+{
+/**
+ * Flat list of the items of the enabled calendars.
+ *
+ * The items are grouped by calendar, so that enabling or disabling a calendar
+ * inserts or removes one block of rows and only looks at the items of that
+ * calendar, instead of filtering a flattened copy of the whole tree.
+ */
+class EVENTVIEWS_TESTS_EXPORT CalendarFilterModel : public QAbstractProxyModel
+{
+    Q_OBJECT
+public:
+    explicit CalendarFilterModel(QObject *parent = nullptr);
+    ~CalendarFilterModel() override;
+
+    void setSourceModel(QAbstractItemModel *model) override;
+
+    /**
+     * Shows the items of the collection @p id. If the collection isn't in the
+     * source model yet, they are shown once it is.
+     */
+    void addCollection(Akonadi::Collection::Id id);
+
+    /**
+     * Hides the items of the collection @p id.
+     */
+    void removeCollection(Akonadi::Collection::Id id);
+
+    [[nodiscard]] QModelIndex index(int row, int column, const QModelIndex &parent = {}) const override;
+    [[nodiscard]] QModelIndex parent(const QModelIndex &child) const override;
+    [[nodiscard]] int rowCount(const QModelIndex &parent = {}) const override;
+    [[nodiscard]] int columnCount(const QModelIndex &parent = {}) const override;
+    [[nodiscard]] QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+    [[nodiscard]] QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+
+protected:
+    /**
+     * Returns the index of the collection @p id in the source model, or an
+     * invalid index if it isn't there.
+     */
+    [[nodiscard]] virtual QModelIndex collectionIndex(Akonadi::Collection::Id id) const;
+
+private:
+    struct CalendarRows {
+        Akonadi::Collection::Id id;
+        QPersistentModelIndex collection;
+        QList<int> itemRows; // Sorted source rows of the items, sub-collections are skipped
+    };
+
+    [[nodiscard]] QList<int> itemRows(const QModelIndex &collection, int first, int last) const;
+    [[nodiscard]] int calendarAt(const QModelIndex &collection) const;
+    [[nodiscard]] int calendarOffset(int i) const;
+    void updateOffsets(int from);
+    void insertCalendar(Akonadi::Collection::Id id, const QModelIndex &collection);
+    void removeCalendarAt(int i);
+    void attachCalendars();
+    void resetCalendars();
+    void sourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void sourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void sourceRowsRemoved(const QModelIndex &parent, int first, int last);
+    void sourceRowsAboutToBeMoved(const QModelIndex &sourceParent, int first, int last, const QModelIndex &destinationParent);
+    void sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+
+    QSet<Akonadi::Collection::Id> mEnabledCalendars;
+    std::vector<CalendarRows> mCalendars; // The enabled calendars present in the source model
+    // First proxy row of each calendar, followed by the row count
+    std::vector<int> mOffsets{0};
+    QList<QMetaObject::Connection> mSourceConnections;
+    bool mRemovingRows = false;
+};
+}
@@ -10,17 +10,94 @@
 
 #include <KCalUtils/IncidenceFormatter>
 
+#include <QHash>
+#include <QTimer>
+
 class ColoredTodoProxyModelPrivate
 {
 public:
     explicit ColoredTodoProxyModelPrivate(const EventViews::PrefsPtr &preferences)
         : m_preferences(preferences)
     {
+        m_midnightTimer.setSingleShot(true);
+        m_dueTimer.setSingleShot(true);
     }
 
+    enum class DueState : quint8 {
+        NotDue,
+        DueToday,
+        Overdue,
+    };
+
+    struct ToolTip {
+        int revision = -1;
+        QString collectionName;
+        QString text;
+    };
+
+    void scheduleMidnight();
+    void scheduleDueTime(const QDateTime &due);
+    void clearDueStates(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void removeToolTips(const QAbstractItemModel *model, const QModelIndex &parent, int first, int last);
+
     EventViews::PrefsPtr m_preferences;
+
+    // Due state of the rows, by the index of their first column. Only valid
+    // for today, see m_midnightTimer, and until the earliest due time still
+    // to come today, see m_dueTimer.
+    QHash<QModelIndex, DueState> m_dueStates;
+
+    // Tool tips by item, valid as long as the item has the same revision
+    // and its collection the same name
+    QHash<Akonadi::Item::Id, ToolTip> m_toolTips;
+
+    QTimer m_midnightTimer;
+    QTimer m_dueTimer; // a to-do cached as due today becomes overdue
 };
 
+void ColoredTodoProxyModelPrivate::scheduleMidnight()
+{
+    // A second late, so that the new day has surely begun
+    const QDateTime now = QDateTime::currentDateTime();
+    m_midnightTimer.start(static_cast<int>(now.msecsTo(now.date().addDays(1).startOfDay())) + 1000);
+}
+
+void ColoredTodoProxyModelPrivate::scheduleDueTime(const QDateTime &due)
+{
+    const qint64 msecs = QDateTime::currentDateTime().msecsTo(due);
+    if (msecs < 0) {
+        return;
+    }
+    // A second late, so that the to-do is surely overdue
+    const int delay = static_cast<int>(msecs) + 1000;
+    if (!m_dueTimer.isActive() || m_dueTimer.remainingTime() > delay) {
+        m_dueTimer.start(delay);
+    }
+}
+
+void ColoredTodoProxyModelPrivate::clearDueStates(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        m_dueStates.remove(topLeft.siblingAtRow(row).siblingAtColumn(0));
+    }
+}
+
+void ColoredTodoProxyModelPrivate::removeToolTips(const QAbstractItemModel *model, const QModelIndex &parent, int first, int last)
+{
+    for (int row = first; row <= last; ++row) {
+        const QModelIndex index = model->index(row, 0, parent);
+        const auto item = index.data(Akonadi::EntityTreeModel::ItemRole).value<Akonadi::Item>();
+        if (item.isValid()) {
+            m_toolTips.remove(item.id());
+        }
+        // Sub-to-dos go with their parent
+        const int childCount = model->rowCount(index);
+        if (childCount > 0) {
+            removeToolTips(model, index, 0, childCount - 1);
+        }
+    }
+}
+
 static bool isDueToday(const KCalendarCore::Todo::Ptr &todo)
 {
     return !todo->isCompleted() && todo->dtDue().date() == QDate::currentDate();
@@ -30,6 +107,44 @@ ColoredTodoProxyModel::ColoredTodoProxyModel(const EventViews::PrefsPtr &prefere
     : QIdentityProxyModel(parent)
     , d(new ColoredTodoProxyModelPrivate(preferences))
 {
+    // Connected before any view, so they never get stale values
+    connect(this, &QAbstractItemModel::dataChanged, this, [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+        d->clearDueStates(topLeft, bottomRight);
+    });
+    const auto clearRows = [this]() {
+        d->m_dueStates.clear();
+    };
+    connect(this, &QAbstractItemModel::rowsInserted, this, clearRows);
+    connect(this, &QAbstractItemModel::rowsAboutToBeRemoved, this, [this](const QModelIndex &parent, int first, int last) {
+        d->removeToolTips(this, parent, first, last);
+    });
+    connect(this, &QAbstractItemModel::rowsRemoved, this, clearRows);
+    connect(this, &QAbstractItemModel::rowsMoved, this, clearRows);
+    connect(this, &QAbstractItemModel::layoutChanged, this, clearRows);
+    connect(this, &QAbstractItemModel::modelReset, this, [this]() {
+        d->m_dueStates.clear();
+        d->m_toolTips.clear();
+    });
+
+    // Due today becomes overdue, and the tool tips mention relative dates
+    connect(&d->m_midnightTimer, &QTimer::timeout, this, [this]() {
+        d->m_dueStates.clear();
+        d->m_toolTips.clear();
+        d->scheduleMidnight();
+        const int rows = rowCount();
+        if (rows > 0) {
+            Q_EMIT dataChanged(index(0, 0), index(rows - 1, columnCount() - 1), {Qt::BackgroundRole, Qt::ToolTipRole});
+        }
+    });
+    d->scheduleMidnight();
+
+    connect(&d->m_dueTimer, &QTimer::timeout, this, [this]() {
+        d->m_dueStates.clear();
+        const int rows = rowCount();
+        if (rows > 0) {
+            Q_EMIT dataChanged(index(0, 0), index(rows - 1, columnCount() - 1), {Qt::BackgroundRole});
+        }
+    });
 }
 
 ColoredTodoProxyModel::~ColoredTodoProxyModel() = default;
@@ -37,34 +152,59 @@ ColoredTodoProxyModel::~ColoredTodoProxyModel() = default;
 QVariant ColoredTodoProxyModel::data(const QModelIndex &index, int role) const
 {
     if (role == Qt::BackgroundRole) {
-        const auto todo = QIdentityProxyModel::data(index, Akonadi::TodoModel::TodoPtrRole).value<KCalendarCore::Todo::Ptr>();
-        if (!todo) {
-            return {};
+        const QModelIndex rowIndex = index.siblingAtColumn(0);
+        auto it = d->m_dueStates.constFind(rowIndex);
+        if (it == d->m_dueStates.cend()) {
+            const auto todo = QIdentityProxyModel::data(index, Akonadi::TodoModel::TodoPtrRole).value<KCalendarCore::Todo::Ptr>();
+            auto state = ColoredTodoProxyModelPrivate::DueState::NotDue;
+            if (todo && todo->isOverdue()) {
+                state = ColoredTodoProxyModelPrivate::DueState::Overdue;
+            } else if (todo && isDueToday(todo)) {
+                state = ColoredTodoProxyModelPrivate::DueState::DueToday;
+                if (!todo->allDay()) {
+                    // Overdue once its due time passes, not at midnight
+                    d->scheduleDueTime(todo->dtDue());
+                }
+            }
+            it = d->m_dueStates.insert(rowIndex, state);
         }
 
-        if (todo->isOverdue()) {
+        switch (it.value()) {
+        case ColoredTodoProxyModelPrivate::DueState::Overdue:
             return QVariant(QBrush(d->m_preferences->todoOverdueColor()));
-        } else if (isDueToday(todo)) {
+        case ColoredTodoProxyModelPrivate::DueState::DueToday:
             return QVariant(QBrush(d->m_preferences->todoDueTodayColor()));
-        } else {
+        case ColoredTodoProxyModelPrivate::DueState::NotDue:
             return {};
         }
+        return {};
     }
 
     if (role == Qt::ToolTipRole) {
-        const auto todo = QIdentityProxyModel::data(index, Akonadi::TodoModel::TodoPtrRole).value<KCalendarCore::Todo::Ptr>();
-        if (!todo) {
-            return {};
-        }
-        QString displayName;
         const Akonadi::Item item = data(index, Akonadi::EntityTreeModel::ItemRole).value<Akonadi::Item>();
+        QString displayName;
         if (item.isValid()) {
+            // Looked up each time, it is cheap compared to the tool tip, and
+            // a renamed collection makes the cached tool tip stale
             const Akonadi::Collection col = Akonadi::EntityTreeModel::updatedCollection(this, item.storageCollectionId());
             if (col.isValid()) {
                 displayName = col.displayName();
             }
+            const auto it = d->m_toolTips.constFind(item.id());
+            if (it != d->m_toolTips.cend() && it->revision == item.revision() && it->collectionName == displayName) {
+                return it->text;
+            }
+        }
+
+        const auto todo = QIdentityProxyModel::data(index, Akonadi::TodoModel::TodoPtrRole).value<KCalendarCore::Todo::Ptr>();
+        if (!todo) {
+            return {};
+        }
+        const QString toolTip = KCalUtils::IncidenceFormatter::toolTipStr(displayName, todo, QDate::currentDate(), true);
+        if (item.isValid()) {
+            d->m_toolTips.insert(item.id(), {item.revision(), displayName, toolTip});
         }
-        return KCalUtils::IncidenceFormatter::toolTipStr(displayName, todo, QDate::currentDate(), true);
+        return toolTip;
     }
 
     return QIdentityProxyModel::data(index, role);
@@ -257,10 +257,27 @@ void TodoCategoriesDelegate::updateEditorGeometry(QWidget *editor, const QStyleO
 // ---------------- RICH TEXT DELEGATE ---------------------------
 // ---------------------------------------------------------------
 
+// Rich text summaries and descriptions kept laid out
+static const int MAX_CACHED_TEXT_DOCUMENTS = 256;
+
 TodoRichTextDelegate::TodoRichTextDelegate(QObject *parent)
     : QStyledItemDelegate(parent)
+    , mTextDocs(MAX_CACHED_TEXT_DOCUMENTS)
+{
+}
+
+QTextDocument *TodoRichTextDelegate::textDocument(const QString &html, int width, const QFont &font) const
 {
-    m_textDoc = new QTextDocument(this);
+    LayoutKey key{html, width, font.key()};
+    QTextDocument *doc = mTextDocs.object(key);
+    if (!doc) {
+        doc = new QTextDocument;
+        doc->setDefaultFont(font);
+        doc->setHtml(html);
+        doc->setTextWidth(width);
+        mTextDocs.insert(std::move(key), doc);
+    }
+    return doc;
 }
 
 void TodoRichTextDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
@@ -299,15 +316,12 @@ void TodoRichTextDelegate::paint(QPainter *painter, const QStyleOptionViewItem &
             painter->drawRect(textRect.adjusted(0, 0, -1, -1));
         }
 
-        m_textDoc->setHtml(index.data().toString());
-
         painter->save();
         painter->translate(textRect.topLeft());
 
         QRect tmpRect = textRect;
         tmpRect.moveTo(0, 0);
-        m_textDoc->setTextWidth(tmpRect.width());
-        m_textDoc->drawContents(painter, tmpRect);
+        textDocument(index.data().toString(), tmpRect.width(), opt.font)->drawContents(painter, tmpRect);
 
         painter->restore();
     } else {
@@ -323,8 +337,7 @@ QSize TodoRichTextDelegate::sizeHint(const QStyleOptionViewItem &option, const Q
 {
     QSize ret = QStyledItemDelegate::sizeHint(option, index);
     if (index.data(Akonadi::TodoModel::IsRichTextRole).toBool()) {
-        m_textDoc->setHtml(index.data().toString());
-        ret = ret.expandedTo(m_textDoc->size().toSize());
+        ret = ret.expandedTo(textDocument(index.data().toString(), -1, option.font)->size().toSize());
     }
     // limit height to max. 2 lines
     // TODO add graphical hint when truncating! make configurable height?
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <QCache>
 #include <QStyledItemDelegate>
 
 class QPainter;
@@ -124,5 +125,30 @@ public:
     QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
 
 private:
-    QTextDocument *m_textDoc = nullptr;
+    struct LayoutKey {
+        QString html;
+        int width; // -1 for the natural width
+        QString font;
+
+        friend bool operator==(const LayoutKey &a, const LayoutKey &b)
+        {
+            return a.width == b.width && a.html == b.html && a.font == b.font;
+        }
+
+        friend size_t qHash(const LayoutKey &key, size_t seed = 0)
+        {
+            return qHashMulti(seed, key.html, key.width, key.font);
+        }
+    };
+
+    /**
+      Returns the laid out document for @p html at @p width, parsing and
+      laying it out only if it isn't cached yet.
+    */
+    QTextDocument *textDocument(const QString &html, int width, const QFont &font) const;
+
+    // Parsing and laying out the HTML is too slow to do on each paint. The
+    // key holds everything the layout depends on, so a changed summary just
+    // misses; the colors come from the paint context, not the document.
+    mutable QCache<LayoutKey, QTextDocument> mTextDocs;
 };
@@ -13,6 +13,7 @@
 #include "todoview.h"
 using namespace Qt::Literals::StringLiterals;
 
+#include "calendarfiltermodel.h"
 #include "calendarview_debug.h"
 #include "coloredtodoproxymodel.h"
 #include "tododelegates.h"
@@ -36,7 +37,6 @@ using namespace Qt::Literals::StringLiterals;
 
 #include <KConfig>
 #include <KDatePickerPopup>
-#include <KDescendantsProxyModel>
 #include <KJob>
 #include <KMessageBox>
 
@@ -44,9 +44,11 @@ using namespace Qt::Literals::StringLiterals;
 #include <QHeaderView>
 #include <QIcon>
 #include <QMenu>
-#include <QSortFilterProxyModel>
+#include <QScrollBar>
 #include <QToolButton>
 
+#include <algorithm>
+
 using namespace std::chrono_literals;
 
 Q_DECLARE_METATYPE(QPointer<QMenu>)
@@ -57,77 +59,6 @@ using namespace KCalendarCore;
 namespace EventViews
 {
 
-class CalendarFilterModel : public QSortFilterProxyModel
-{
-    Q_OBJECT
-public:
-    explicit CalendarFilterModel(QObject *parent = nullptr)
-        : QSortFilterProxyModel(parent)
-    {
-        mDescendantsProxy.setDisplayAncestorData(false);
-        QSortFilterProxyModel::setSourceModel(&mDescendantsProxy);
-    }
-
-    void setSourceModel(QAbstractItemModel *model) override
-    {
-        mDescendantsProxy.setSourceModel(model);
-    }
-
-    void addCalendar(const Akonadi::CollectionCalendar::Ptr &calendar)
-    {
-        if (!calendar || !calendar->collection().isValid()) {
-            return;
-        }
-        if (mEnabledCalendars.contains(calendar->collection().id())) {
-            return;
-        }
-#if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
-        beginFilterChange();
-#endif
-        mEnabledCalendars.insert(calendar->collection().id());
-#if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
-        endFilterChange(QSortFilterProxyModel::Direction::Rows);
-#else
-        invalidateFilter();
-#endif
-    }
-
-    void removeCalendar(const Akonadi::CollectionCalendar::Ptr &calendar)
-    {
-        if (!calendar || !calendar->collection().isValid()) {
-            return;
-        }
-        if (!mEnabledCalendars.contains(calendar->collection().id())) {
-            return;
-        }
-#if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
-        beginFilterChange();
-#endif
-        mEnabledCalendars.remove(calendar->collection().id());
-#if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
-        endFilterChange(QSortFilterProxyModel::Direction::Rows);
-#else
-        invalidateFilter();
-#endif
-    }
-
-protected:
-    bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const override
-    {
-        const auto source_index = sourceModel()->index(source_row, 0, source_parent);
-        const auto item = sourceModel()->data(source_index, Akonadi::EntityTreeModel::ItemRole).value<Akonadi::Item>();
-
-        if (!item.isValid()) {
-            return false;
-        }
-        return mEnabledCalendars.contains(item.parentCollection().id());
-    }
-
-private:
-    KDescendantsProxyModel mDescendantsProxy;
-    QSet<Akonadi::Collection::Id> mEnabledCalendars;
-};
-
 // We share this struct between all views, for performance and memory purposes
 class ModelStack
 {
@@ -162,40 +93,52 @@ public:
 
     void setFlatView(bool flat)
     {
-        const QString todoMimeType = QStringLiteral("application/x-vnd.akonadi.calendar.todo");
         if (flat) {
             for (TodoView *view : std::as_const(views)) {
                 // In flatview dropping confuses users and it's very easy to drop into a child item
                 view->mView->setDragDropMode(QAbstractItemView::DragOnly);
                 view->setFlatView(flat, /**propagate=*/false); // So other views update their toggle icon
 
-                if (todoTreeModel) {
-                    view->saveViewState(); // Save the tree state before it's gone
+                if (!flatView && todoTreeModel) {
+                    view->saveViewState(); // Save the tree state before the view is reset
                 }
             }
 
-            delete todoFlatModel;
-            todoFlatModel = new Akonadi::EntityMimeTypeFilterModel(parent);
-            todoFlatModel->addMimeTypeInclusionFilter(todoMimeType);
-            todoFlatModel->setSourceModel(model);
-            todoModel->setSourceModel(todoFlatModel);
-
-            delete todoTreeModel;
-            todoTreeModel = nullptr;
+            // The flat model is built once and then kept up to date, so switching back is cheap
+            if (!todoFlatModel) {
+                todoFlatModel = new Akonadi::EntityMimeTypeFilterModel(parent);
+                todoFlatModel->addMimeTypeInclusionFilter(todoMimeType());
+                todoFlatModel->setSourceModel(model);
+            }
+            if (todoModel->sourceModel() != todoFlatModel) {
+                todoModel->setSourceModel(todoFlatModel);
+            }
         } else {
-            delete todoTreeModel;
-            todoTreeModel = new Akonadi::IncidenceTreeModel(QStringList() << todoMimeType, parent);
+            // Same for the tree model, whose hierarchy is expensive to build
+            if (!todoTreeModel) {
+                todoTreeModel = new Akonadi::IncidenceTreeModel(QStringList() << todoMimeType(), parent);
+                todoTreeModel->setSourceModel(model);
+            }
             for (TodoView *view : std::as_const(views)) {
-                QObject::connect(todoTreeModel, &Akonadi::IncidenceTreeModel::indexChangedParent, view, &TodoView::expandIndex);
-                QObject::connect(todoTreeModel, &Akonadi::IncidenceTreeModel::batchInsertionFinished, view, &TodoView::restoreViewState);
+                QObject::connect(todoTreeModel, &Akonadi::IncidenceTreeModel::indexChangedParent, view, &TodoView::expandIndex, Qt::UniqueConnection);
+                QObject::connect(todoTreeModel,
+                                 &Akonadi::IncidenceTreeModel::batchInsertionFinished,
+                                 view,
+                                 &TodoView::restoreViewState,
+                                 Qt::UniqueConnection);
+                QObject::connect(todoTreeModel,
+                                 &Akonadi::IncidenceTreeModel::batchInsertionFinished,
+                                 view,
+                                 &TodoView::applyInsertedRows,
+                                 Qt::UniqueConnection);
                 view->mView->setDragDropMode(QAbstractItemView::DragDrop);
                 view->setFlatView(flat, /**propagate=*/false); // So other views update their toggle icon
             }
-            todoTreeModel->setSourceModel(model);
-            todoModel->setSourceModel(todoTreeModel);
-            delete todoFlatModel;
-            todoFlatModel = nullptr;
+            if (todoModel->sourceModel() != todoTreeModel) {
+                todoModel->setSourceModel(todoTreeModel);
+            }
         }
+        flatView = flat;
 
         for (TodoView *view : std::as_const(views)) {
             view->mFlatViewButton->blockSignals(true);
@@ -203,11 +146,16 @@ public:
             view->mFlatViewButton->setChecked(flat);
             view->mFlatViewButton->blockSignals(false);
             view->mView->setRootIsDecorated(!flat);
-            view->restoreViewState();
+            // Expanding the saved tree state can wait until the switch is painted
+            QTimer::singleShot(0, view, &TodoView::restoreViewState);
         }
 
         prefs->setFlatListTodo(flat);
-        prefs->writeConfig();
+        if (!views.isEmpty()) {
+            QTimer::singleShot(0, views.constFirst(), [prefs = prefs]() {
+                prefs->writeConfig();
+            });
+        }
     }
 
     void setModel(QAbstractItemModel *newModel)
@@ -216,11 +164,14 @@ public:
         if (todoTreeModel) {
             todoTreeModel->setSourceModel(this->model);
         }
+        if (todoFlatModel) {
+            todoFlatModel->setSourceModel(this->model);
+        }
     }
 
     bool isFlatView() const
     {
-        return todoFlatModel != nullptr;
+        return flatView;
     }
 
     Akonadi::TodoModel *const todoModel;
@@ -234,6 +185,13 @@ public:
     EventViews::PrefsPtr prefs;
 
 private:
+    static QString todoMimeType()
+    {
+        return QStringLiteral("application/x-vnd.akonadi.calendar.todo");
+    }
+
+    bool flatView = false;
+
     Q_DISABLE_COPY_MOVE(ModelStack)
 };
 }
@@ -241,6 +199,19 @@ private:
 // Don't use K_GLOBAL_STATIC, see QTBUG-22667
 static ModelStack *sModels = nullptr;
 
+// Columns sized to their contents rather than stretched
+static const int sContentSizedColumns[] = {Akonadi::TodoModel::StartDateColumn,
+                                           Akonadi::TodoModel::DueDateColumn,
+                                           Akonadi::TodoModel::CompletedDateColumn,
+                                           Akonadi::TodoModel::PriorityColumn,
+                                           Akonadi::TodoModel::CalendarColumn,
+                                           Akonadi::TodoModel::RecurColumn,
+                                           Akonadi::TodoModel::PercentColumn};
+
+// Rows measured in addition to the visible ones when sizing a column to its
+// contents, so that resizing doesn't go through every to-do
+static const int COLUMN_SIZE_SAMPLE_ROWS = 100;
+
 TodoView::TodoView(const EventViews::PrefsPtr &prefs, bool sidebarView, QWidget *parent)
     : EventView(parent)
     , mCalendarFilterModel(std::make_unique<CalendarFilterModel>())
@@ -253,6 +224,15 @@ TodoView::TodoView(const EventViews::PrefsPtr &prefs, bool sidebarView, QWidget
     mResizeColumnsTimer->setInterval(100ms); // so we don't overdue it when user resizes window manually
     mResizeColumnsTimer->setSingleShot(true);
 
+    mGrowColumnsTimer = new QTimer(this);
+    connect(mGrowColumnsTimer, &QTimer::timeout, this, &TodoView::growColumnsToVisibleRows);
+    mGrowColumnsTimer->setInterval(100ms);
+    mGrowColumnsTimer->setSingleShot(true);
+
+    mInsertedRowsTimer = new QTimer(this);
+    connect(mInsertedRowsTimer, &QTimer::timeout, this, &TodoView::applyInsertedRows);
+    mInsertedRowsTimer->setSingleShot(true);
+
     setPreferences(prefs);
     if (!sModels) {
         sModels = new ModelStack(prefs, parent);
@@ -276,10 +256,7 @@ TodoView::TodoView(const EventViews::PrefsPtr &prefs, bool sidebarView, QWidget
     if (!mSidebarView) {
         mQuickSearch = new TodoViewQuickSearch(this);
         mQuickSearch->setVisible(prefs->enableTodoQuickSearch());
-        connect(mQuickSearch,
-                &TodoViewQuickSearch::searchTextChanged,
-                mProxyModel,
-                qOverload<const QString &>(&QSortFilterProxyModel::setFilterRegularExpression));
+        connect(mQuickSearch, &TodoViewQuickSearch::searchTextChanged, mProxyModel, &TodoViewSortFilterProxyModel::setSearchText);
         connect(mQuickSearch, &TodoViewQuickSearch::searchTextChanged, this, &TodoView::restoreViewState);
         connect(mQuickSearch, &TodoViewQuickSearch::filterCategoryChanged, mProxyModel, &TodoViewSortFilterProxyModel::setCategoryFilter);
         connect(mQuickSearch, &TodoViewQuickSearch::filterCategoryChanged, this, &TodoView::restoreViewState);
@@ -303,6 +280,12 @@ TodoView::TodoView(const EventViews::PrefsPtr &prefs, bool sidebarView, QWidget
     connect(mView->header(), &QHeaderView::geometriesChanged, this, &TodoView::scheduleResizeColumns);
     connect(mView, &TodoViewView::visibleColumnCountChanged, this, &TodoView::resizeColumns);
 
+    // Columns are sized from the visible rows and a bounded sample, so widen
+    // them when rows that weren't measured come into view
+    mView->header()->setResizeContentsPrecision(COLUMN_SIZE_SAMPLE_ROWS);
+    connect(mView->verticalScrollBar(), &QScrollBar::valueChanged, mGrowColumnsTimer, qOverload<>(&QTimer::start));
+    connect(mView, &TodoViewView::expanded, mGrowColumnsTimer, qOverload<>(&QTimer::start));
+
     auto richTextDelegate = new TodoRichTextDelegate(mView);
     mView->setItemDelegateForColumn(Akonadi::TodoModel::SummaryColumn, richTextDelegate);
     mView->setItemDelegateForColumn(Akonadi::TodoModel::DescriptionColumn, richTextDelegate);
@@ -551,7 +534,7 @@ void TodoView::addCalendar(const Akonadi::CollectionCalendar::Ptr &calendar)
 {
     if (calendar && calendar->collection().isValid()) {
         EventView::addCalendar(calendar);
-        mCalendarFilterModel->addCalendar(calendar);
+        mCalendarFilterModel->addCollection(calendar->collection().id());
         if (calendars().size() == 1) {
             mProxyModel->setCalFilter(calendar->filter());
         }
@@ -561,7 +544,7 @@ void TodoView::addCalendar(const Akonadi::CollectionCalendar::Ptr &calendar)
 void TodoView::removeCalendar(const Akonadi::CollectionCalendar::Ptr &calendar)
 {
     if (calendar && calendar->collection().isValid()) {
-        mCalendarFilterModel->removeCalendar(calendar);
+        mCalendarFilterModel->removeCollection(calendar->collection().id());
         EventView::removeCalendar(calendar);
     }
 }
@@ -1231,47 +1214,54 @@ void TodoView::onRowsInserted(const QModelIndex &parent, int start, int end)
         return;
     }
 
-    const QModelIndex idx = mView->model()->index(start, 0);
+    const QModelIndex idx = mView->model()->index(start, 0, parent);
 
     // If the collection is currently being populated, we don't do anything
-    const QVariant v = idx.data(Akonadi::EntityTreeModel::ItemRole);
-    if (!v.isValid()) {
+    const auto item = idx.data(Akonadi::EntityTreeModel::ItemRole).value<Akonadi::Item>();
+    if (!item.isValid() || !entityTreeModel()->isCollectionPopulated(item.storageCollectionId())) {
         return;
     }
 
-    auto item = v.value<Akonadi::Item>();
-    if (!item.isValid()) {
+    // Applied once the IncidenceTreeModel batch is over (or on the next event
+    // loop iteration) so the view isn't laid out again for every row
+    if (!parent.isValid()) {
+        // Case #1, adding an item that doesn't have parent: We select the last one
+        mInsertedTopLevelRow = idx;
+    } else if (!sModels->isFlatView()) {
+        // Case 2: Adding an item that has a parent: we expand the parent
+        mParentsToExpand.insert(parent);
+    } else {
         return;
     }
+    mInsertedRowsTimer->start();
+}
 
-    const bool isPopulated = entityTreeModel()->isCollectionPopulated(item.storageCollectionId());
-    if (!isPopulated) {
-        return;
+void TodoView::applyInsertedRows()
+{
+    mInsertedRowsTimer->stop();
+    const QModelIndex selectedIndex = std::exchange(mInsertedTopLevelRow, {});
+    const QSet<QPersistentModelIndex> parents = std::exchange(mParentsToExpand, {});
+
+    QSet<QModelIndex> expandedParents;
+    for (const QPersistentModelIndex &parent : parents) {
+        for (QModelIndex index = parent; index.isValid(); index = index.parent()) {
+            if (expandedParents.contains(index)) {
+                break;
+            }
+            expandedParents.insert(index);
+            mView->expand(index);
+        }
     }
 
-    // Case #1, adding an item that doesn't have parent: We select it
-    if (!parent.isValid()) {
+    if (selectedIndex.isValid()) {
         const QModelIndexList selection = mView->selectionModel()->selectedRows();
         if (selection.size() <= 1) {
             // don't destroy complex selections, not applicable now (only single
             // selection allowed), but for the future...
             const int colCount = static_cast<int>(Akonadi::TodoModel::ColumnCount);
-            mView->selectionModel()->select(QItemSelection(idx, mView->model()->index(start, colCount - 1)),
+            mView->selectionModel()->select(QItemSelection(selectedIndex, selectedIndex.siblingAtColumn(colCount - 1)),
                                             QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
         }
-        return;
-    }
-
-    // Case 2: Adding an item that has a parent: we expand the parent
-    if (sModels->isFlatView()) {
-        return;
-    }
-
-    QModelIndex index = parent;
-    mView->expand(index);
-    while (index.parent().isValid()) {
-        mView->expand(index.parent());
-        index = index.parent();
     }
 }
 
@@ -1301,14 +1291,40 @@ void TodoView::resizeColumns()
 {
     mResizeColumnsScheduled = false;
 
-    mView->resizeColumnToContents(Akonadi::TodoModel::StartDateColumn);
-    mView->resizeColumnToContents(Akonadi::TodoModel::DueDateColumn);
-    mView->resizeColumnToContents(Akonadi::TodoModel::CompletedDateColumn);
-    mView->resizeColumnToContents(Akonadi::TodoModel::PriorityColumn);
-    mView->resizeColumnToContents(Akonadi::TodoModel::CalendarColumn);
-    mView->resizeColumnToContents(Akonadi::TodoModel::RecurColumn);
-    mView->resizeColumnToContents(Akonadi::TodoModel::PercentColumn);
+    for (int column : sContentSizedColumns) {
+        mView->resizeColumnToContents(column);
+    }
+
+    resizeStretchedColumns();
+}
+
+void TodoView::growColumnsToVisibleRows()
+{
+    QHeaderView *header = mView->header();
+    const int precision = header->resizeContentsPrecision();
+    header->setResizeContentsPrecision(0); // visible rows only
+
+    bool grown = false;
+    for (int column : sContentSizedColumns) {
+        if (mView->isColumnHidden(column)) {
+            continue;
+        }
+        const int width = std::max(mView->sizeHintForColumn(column), header->sectionSizeHint(column));
+        if (width > mView->columnWidth(column)) {
+            mView->setColumnWidth(column, width);
+            grown = true;
+        }
+    }
 
+    header->setResizeContentsPrecision(precision);
+
+    if (grown) {
+        resizeStretchedColumns();
+    }
+}
+
+void TodoView::resizeStretchedColumns()
+{
     // We have 3 columns that should stretch: summary, description and categories.
     // Summary is always visible.
     const bool descriptionVisible = !mView->isColumnHidden(Akonadi::TodoModel::DescriptionColumn);
@@ -1404,6 +1420,4 @@ void TodoView::createEvent()
     Q_EMIT createEvent(todoItem);
 }
 
-#include "todoview.moc"
-
 #include "moc_todoview.cpp"
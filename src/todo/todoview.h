@@ -15,7 +15,9 @@
 #include "eventview.h"
 #include <Akonadi/IncidenceChanger>
 
+#include <QPersistentModelIndex>
 #include <QPointer>
+#include <QSet>
 #include <akonadi/collectioncalendar.h>
 
 class KJob;
@@ -200,6 +202,7 @@ protected Q_SLOTS:
 private Q_SLOTS:
     EVENTVIEWS_NO_EXPORT void scheduleResizeColumns();
     EVENTVIEWS_NO_EXPORT void resizeColumns();
+    EVENTVIEWS_NO_EXPORT void growColumnsToVisibleRows();
     EVENTVIEWS_NO_EXPORT void itemDoubleClicked(const QModelIndex &index);
     EVENTVIEWS_NO_EXPORT void setNewDate(QDate date);
     EVENTVIEWS_NO_EXPORT void setStartDate(QDate date);
@@ -211,6 +214,7 @@ private Q_SLOTS:
     EVENTVIEWS_NO_EXPORT void setFlatView(bool flatView, bool notifyOtherViews = true);
 
     EVENTVIEWS_NO_EXPORT void onRowsInserted(const QModelIndex &parent, int start, int end);
+    EVENTVIEWS_NO_EXPORT void applyInsertedRows();
     EVENTVIEWS_NO_EXPORT void onTagsFetched(KJob *);
 
 Q_SIGNALS:
@@ -226,6 +230,7 @@ Q_SIGNALS:
 private:
     EVENTVIEWS_NO_EXPORT QMenu *createCategoryPopupMenu();
     EVENTVIEWS_NO_EXPORT QString stateSaverGroup() const;
+    EVENTVIEWS_NO_EXPORT void resizeStretchedColumns();
 
     /*! Creates a new todo with the given text as summary under the given parent */
     void addTodo(const QString &summary, const Akonadi::Item &parentItem, const QStringList &categories = QStringList());
@@ -259,5 +264,10 @@ private:
     bool mSidebarView;
     bool mResizeColumnsScheduled;
     QTimer *mResizeColumnsTimer = nullptr;
+    QTimer *mGrowColumnsTimer = nullptr;
+    QTimer *mInsertedRowsTimer = nullptr;
+    // What applyInsertedRows() does once the inserted rows are settled
+    QPersistentModelIndex mInsertedTopLevelRow;
+    QSet<QPersistentModelIndex> mParentsToExpand;
 };
 }
@@ -23,10 +23,15 @@
 #include <QLineEdit>
 
 #include <QHBoxLayout>
+#include <QTimer>
+
+// Delay between the last keystroke and the filtering
+static const int SEARCH_DELAY = 200;
 
 TodoViewQuickSearch::TodoViewQuickSearch(QWidget *parent)
     : QWidget(parent)
     , mSearchLine(new QLineEdit(this))
+    , mSearchTimer(new QTimer(this))
     , mCategoryCombo(new Akonadi::TagSelectionComboBox(this))
     , mPriorityCombo(new KPIM::KCheckComboBox(this))
 {
@@ -38,7 +43,27 @@ TodoViewQuickSearch::TodoViewQuickSearch(QWidget *parent)
     mSearchLine->setWhatsThis(i18nc("@info:whatsthis", "Enter text here to filter the to-dos that are shown by matching summaries."));
     mSearchLine->setPlaceholderText(i18nc("@label in QuickSearchLine", "Search Summaries…"));
     mSearchLine->setClearButtonEnabled(true);
-    connect(mSearchLine, &QLineEdit::textChanged, this, &TodoViewQuickSearch::searchTextChanged);
+    // Every change refilters the whole to-do tree, so wait until the user
+    // stops typing. Clearing the search or pressing Return applies it at once.
+    mSearchTimer->setSingleShot(true);
+    mSearchTimer->setInterval(SEARCH_DELAY);
+    connect(mSearchTimer, &QTimer::timeout, this, [this]() {
+        Q_EMIT searchTextChanged(mSearchLine->text());
+    });
+    connect(mSearchLine, &QLineEdit::textChanged, this, [this](const QString &text) {
+        if (text.isEmpty()) {
+            mSearchTimer->stop();
+            Q_EMIT searchTextChanged(text);
+        } else {
+            mSearchTimer->start();
+        }
+    });
+    connect(mSearchLine, &QLineEdit::returnPressed, this, [this]() {
+        if (mSearchTimer->isActive()) {
+            mSearchTimer->stop();
+            Q_EMIT searchTextChanged(mSearchLine->text());
+        }
+    });
 
     layout->addWidget(mSearchLine, 3);
 
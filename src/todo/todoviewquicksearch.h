@@ -23,6 +23,7 @@ class TagSelectionComboBox;
 }
 
 class QLineEdit;
+class QTimer;
 
 class TodoViewQuickSearch : public QWidget
 {
@@ -50,6 +51,7 @@ private:
     void fillPriorities();
 
     QLineEdit *const mSearchLine;
+    QTimer *const mSearchTimer; // emits searchTextChanged() once typing pauses
     Akonadi::TagSelectionComboBox *const mCategoryCombo;
     KPIM::KCheckComboBox *const mPriorityCombo;
 };
@@ -14,6 +14,10 @@
 
 #include <KLocalizedString>
 
+#include <QRegularExpression>
+
+#include <limits>
+
 TodoViewSortFilterProxyModel::TodoViewSortFilterProxyModel(const EventViews::PrefsPtr &prefs, QObject *parent)
     : QSortFilterProxyModel(parent)
     , mPreferences(prefs)
@@ -26,16 +30,107 @@ void TodoViewSortFilterProxyModel::sort(int column, Qt::SortOrder order)
     QSortFilterProxyModel::sort(column, order);
 }
 
+void TodoViewSortFilterProxyModel::setSourceModel(QAbstractItemModel *model)
+{
+    for (const QMetaObject::Connection &connection : std::as_const(mSourceConnections)) {
+        disconnect(connection);
+    }
+    mSourceConnections.clear();
+
+    // Connected before QSortFilterProxyModel's own handlers, so that they
+    // don't filter or sort with stale results. Any change can move rows,
+    // change their data or which descendants are accepted, so forget everything.
+    if (model) {
+        mSourceConnections = {
+            connect(model, &QAbstractItemModel::dataChanged, this, &TodoViewSortFilterProxyModel::clearRowCaches),
+            connect(model, &QAbstractItemModel::rowsInserted, this, &TodoViewSortFilterProxyModel::clearRowCaches),
+            connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this, &TodoViewSortFilterProxyModel::clearRowCaches),
+            connect(model, &QAbstractItemModel::rowsRemoved, this, &TodoViewSortFilterProxyModel::clearRowCaches),
+            connect(model, &QAbstractItemModel::rowsMoved, this, &TodoViewSortFilterProxyModel::clearRowCaches),
+            connect(model, &QAbstractItemModel::columnsInserted, this, &TodoViewSortFilterProxyModel::clearRowCaches),
+            connect(model, &QAbstractItemModel::columnsRemoved, this, &TodoViewSortFilterProxyModel::clearRowCaches),
+            connect(model, &QAbstractItemModel::columnsMoved, this, &TodoViewSortFilterProxyModel::clearRowCaches),
+            connect(model, &QAbstractItemModel::layoutChanged, this, &TodoViewSortFilterProxyModel::clearRowCaches),
+            connect(model, &QAbstractItemModel::modelReset, this, &TodoViewSortFilterProxyModel::clearRowCaches),
+        };
+    }
+    // invalidate() from outside, e.g. after the CalFilter was edited
+    connect(this, &QAbstractItemModel::layoutAboutToBeChanged, this, &TodoViewSortFilterProxyModel::clearAcceptedRows, Qt::UniqueConnection);
+
+    clearRowCaches();
+    QSortFilterProxyModel::setSourceModel(model);
+}
+
+void TodoViewSortFilterProxyModel::clearAcceptedRows()
+{
+    mAcceptedRows.clear();
+}
+
+void TodoViewSortFilterProxyModel::checkBaseFilter() const
+{
+    const QRegularExpression expression = filterRegularExpression();
+    if (expression == mBaseFilterExpression && filterKeyColumn() == mBaseFilterKeyColumn && filterRole() == mBaseFilterRole) {
+        return;
+    }
+
+    // The case sensitivity is part of the expression's options
+    mBaseFilterExpression = expression;
+    mBaseFilterKeyColumn = filterKeyColumn();
+    mBaseFilterRole = filterRole();
+    mAcceptedRows.clear();
+    mSearchMatches.clear();
+    mPreviousSearchMatches.clear();
+}
+
+void TodoViewSortFilterProxyModel::clearRowCaches()
+{
+    clearAcceptedRows();
+    clearSortKeys();
+    mSearchMatches.clear();
+    mPreviousSearchMatches.clear();
+}
+
 bool TodoViewSortFilterProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
 {
-    bool ret = QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
+    checkBaseFilter();
+
+    const QModelIndex cur = sourceModel()->index(source_row, Akonadi::TodoModel::SummaryColumn, source_parent);
+    if (!cur.isValid()) {
+        return rowMatchesFilters(source_row, source_parent) == RowMatch::Accepted;
+    }
+
+    const auto it = mAcceptedRows.constFind(cur);
+    if (it != mAcceptedRows.cend()) {
+        return it.value();
+    }
+
+    const RowMatch match = rowMatchesFilters(source_row, source_parent);
+    bool accepted = match == RowMatch::Accepted;
+    if (match == RowMatch::Rejected) {
+        // check if one of the children is accepted, and accept this node too if so
+        const int rowCount = cur.model()->rowCount(cur);
+        for (int r = 0; r < rowCount; ++r) {
+            if (filterAcceptsRow(r, cur)) {
+                accepted = true;
+                break;
+            }
+        }
+    }
+
+    mAcceptedRows.insert(cur, accepted);
+    return accepted;
+}
+
+TodoViewSortFilterProxyModel::RowMatch TodoViewSortFilterProxyModel::rowMatchesFilters(int source_row, const QModelIndex &source_parent) const
+{
+    bool ret = matchesSearchText(source_row, source_parent);
 
     if (ret && mCalFilter) {
         const QModelIndex cur = sourceModel()->index(source_row, Akonadi::TodoModel::SummaryColumn, source_parent);
         if (cur.isValid()) {
             const auto incidence = cur.data(Akonadi::TodoModel::TodoPtrRole).value<KCalendarCore::Todo::Ptr>();
             if (!incidence || !mCalFilter->filterIncidence(incidence)) {
-                return false;
+                return RowMatch::Hidden;
             }
         }
     }
@@ -51,34 +146,98 @@ bool TodoViewSortFilterProxyModel::filterAcceptsRow(int source_row, const QModel
 
         for (const QString &category : categoryList) {
             if (mCategories.contains(category)) {
-                return returnValue && true;
+                return returnValue ? RowMatch::Accepted : RowMatch::Hidden;
             }
         }
         ret = false;
     }
 
-    // check if one of the children is accepted, and accept this node too if so
-    const QModelIndex cur = sourceModel()->index(source_row, Akonadi::TodoModel::SummaryColumn, source_parent);
-    if (cur.isValid()) {
-        for (int r = 0; r < cur.model()->rowCount(cur); ++r) {
-            if (filterAcceptsRow(r, cur)) {
-                return true;
-            }
+    return ret && returnValue ? RowMatch::Accepted : RowMatch::Rejected;
+}
+
+// Same order as QSortFilterProxyModel::lessThan()
+static bool variantLessThan(const QVariant &left, const QVariant &right, Qt::CaseSensitivity cs, bool localeAware)
+{
+    if (left.userType() == QMetaType::UnknownType) {
+        return false;
+    }
+    if (right.userType() == QMetaType::UnknownType) {
+        return true;
+    }
+    switch (left.userType()) {
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Float:
+    case QMetaType::Double:
+    case QMetaType::QChar:
+    case QMetaType::QDate:
+    case QMetaType::QTime:
+    case QMetaType::QDateTime:
+        return QVariant::compare(left, right) == QPartialOrdering::Less;
+    default:
+        if (localeAware) {
+            return left.toString().localeAwareCompare(right.toString()) < 0;
         }
+        return left.toString().compare(right.toString(), cs) < 0;
+    }
+}
+
+static qint64 sortableDateTime(const QDateTime &dateTime)
+{
+    // Invalid dates sort before all others, as with QDateTime's operator<
+    return dateTime.isValid() ? dateTime.toMSecsSinceEpoch() : std::numeric_limits<qint64>::min();
+}
+
+const TodoViewSortFilterProxyModel::SortKey &TodoViewSortFilterProxyModel::sortKey(const QModelIndex &index) const
+{
+    if (index.column() != mSortKeyColumn) {
+        // The column values are those of the sort column
+        mSortKeys.clear();
+        mSortKeyColumn = index.column();
     }
 
-    return ret && returnValue;
+    const QModelIndex summaryIndex = index.siblingAtColumn(Akonadi::TodoModel::SummaryColumn);
+    auto it = mSortKeys.find(summaryIndex);
+    if (it != mSortKeys.end()) {
+        return it.value();
+    }
+
+    SortKey key;
+    key.columnValue = index.data(sortRole());
+    key.columnDisplay = index.data();
+    key.summaryValue = summaryIndex.data(sortRole());
+    key.percent = index.siblingAtColumn(Akonadi::TodoModel::PercentColumn).data(Qt::EditRole).toInt();
+    if (const auto todo = summaryIndex.data(Akonadi::TodoModel::TodoPtrRole).value<KCalendarCore::Todo::Ptr>()) {
+        key.hasTodo = true;
+        key.priority = todo->priority();
+        key.hasDueDate = todo->hasDueDate();
+        key.dueDate = key.hasDueDate ? sortableDateTime(todo->dtDue()) : 0;
+        key.hasStartDate = todo->hasStartDate();
+        key.startDate = key.hasStartDate ? sortableDateTime(todo->dtStart()) : 0;
+        key.hasCompletedDate = todo->hasCompletedDate();
+        key.completedDate = sortableDateTime(todo->completed());
+    }
+    return mSortKeys.insert(summaryIndex, key).value();
+}
+
+void TodoViewSortFilterProxyModel::clearSortKeys()
+{
+    mSortKeys.clear();
 }
 
 bool TodoViewSortFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
-    if (mPreferences->sortCompletedTodosSeparately() && left.column() != Akonadi::TodoModel::PercentColumn) {
-        const QModelIndex cLeft = left.sibling(left.row(), Akonadi::TodoModel::PercentColumn);
-        const QModelIndex cRight = right.sibling(right.row(), Akonadi::TodoModel::PercentColumn);
+    // Both keys are created before taking references, inserting one could move the other
+    sortKey(left);
+    const SortKey &r = sortKey(right);
+    const SortKey &l = sortKey(left);
 
-        if (cRight.data(Qt::EditRole).toInt() == 100 && cLeft.data(Qt::EditRole).toInt() != 100) {
+    if (mPreferences->sortCompletedTodosSeparately() && left.column() != Akonadi::TodoModel::PercentColumn) {
+        if (r.percent == 100 && l.percent != 100) {
             return mSortOrder == Qt::AscendingOrder ? true : false;
-        } else if (cRight.data(Qt::EditRole).toInt() != 100 && cLeft.data(Qt::EditRole).toInt() == 100) {
+        } else if (r.percent != 100 && l.percent == 100) {
             return mSortOrder == Qt::AscendingOrder ? false : true;
         }
     }
@@ -86,67 +245,63 @@ bool TodoViewSortFilterProxyModel::lessThan(const QModelIndex &left, const QMode
     // To-dos without due date should appear last when sorting ascending,
     // so you can see the most urgent tasks first. (bug #174763)
     if (right.column() == Akonadi::TodoModel::DueDateColumn) {
-        const int comparison = compareDueDates(left, right);
+        const int comparison = compareDueDates(l, r);
 
         if (comparison != 0) {
             return comparison == -1;
         } else {
             // Due dates are equal, but the user still expects sorting by importance
             // Fallback to the PriorityColumn
-            const QModelIndex leftPriorityIndex = left.sibling(left.row(), Akonadi::TodoModel::PriorityColumn);
-            const QModelIndex rightPriorityIndex = right.sibling(right.row(), Akonadi::TodoModel::PriorityColumn);
-            const int fallbackComparison = comparePriorities(leftPriorityIndex, rightPriorityIndex);
+            const int fallbackComparison = comparePriorities(l, r);
 
             if (fallbackComparison != 0) {
                 return fallbackComparison == 1;
             }
         }
     } else if (right.column() == Akonadi::TodoModel::StartDateColumn) {
-        return compareStartDates(left, right) == -1;
+        return compareStartDates(l, r) == -1;
     } else if (right.column() == Akonadi::TodoModel::CompletedDateColumn) {
-        return compareCompletedDates(left, right) == -1;
+        return compareCompletedDates(l, r) == -1;
     } else if (right.column() == Akonadi::TodoModel::PriorityColumn) {
-        const int comparison = comparePriorities(left, right);
+        const int comparison = comparePriorities(l, r);
 
         if (comparison != 0) {
             return comparison == -1;
         } else {
             // Priorities are equal, but the user still expects sorting by importance
             // Fallback to the DueDateColumn
-            const QModelIndex leftDueDateIndex = left.sibling(left.row(), Akonadi::TodoModel::DueDateColumn);
-            const QModelIndex rightDueDateIndex = right.sibling(right.row(), Akonadi::TodoModel::DueDateColumn);
-            const int fallbackComparison = compareDueDates(leftDueDateIndex, rightDueDateIndex);
+            const int fallbackComparison = compareDueDates(l, r);
 
             if (fallbackComparison != 0) {
                 return fallbackComparison == 1;
             }
         }
     } else if (right.column() == Akonadi::TodoModel::PercentColumn) {
-        const int comparison = compareCompletion(left, right);
+        const int comparison = compareCompletion(l, r);
         if (comparison != 0) {
             return comparison == -1;
         }
     }
 
-    if (left.data() == right.data()) {
+    const Qt::CaseSensitivity cs = sortCaseSensitivity();
+    const bool localeAware = isSortLocaleAware();
+    if (l.columnDisplay == r.columnDisplay) {
         // If both are equal, lets choose an order, otherwise Qt will display them randomly.
         // Fixes to-dos jumping around when you have calendar A selected, and then check/uncheck
         // a calendar B with no to-dos. No to-do is added/removed because calendar B is empty,
         // but you see the existing to-dos switching places.
-        const QModelIndex leftSummaryIndex = left.sibling(left.row(), Akonadi::TodoModel::SummaryColumn);
-        const QModelIndex rightSummaryIndex = right.sibling(right.row(), Akonadi::TodoModel::SummaryColumn);
 
         // This patch is not about fallingback to the SummaryColumn for sorting.
         // It's about avoiding jumping due to random reasons.
         // That's why we ignore the sort direction...
-        return mSortOrder == Qt::AscendingOrder ? QSortFilterProxyModel::lessThan(leftSummaryIndex, rightSummaryIndex)
-                                                : QSortFilterProxyModel::lessThan(rightSummaryIndex, leftSummaryIndex);
+        return mSortOrder == Qt::AscendingOrder ? variantLessThan(l.summaryValue, r.summaryValue, cs, localeAware)
+                                                : variantLessThan(r.summaryValue, l.summaryValue, cs, localeAware);
 
         // ...so, if you have 4 to-dos, all with CompletionColumn = "55%",
         // and click the header multiple times, nothing will happen because
         // it is already sorted by Completion.
     } else {
-        return QSortFilterProxyModel::lessThan(left, right);
+        return variantLessThan(l.columnValue, r.columnValue, cs, localeAware);
     }
 }
 
@@ -156,6 +311,7 @@ void TodoViewSortFilterProxyModel::setPriorityFilter(const QStringList &prioriti
     beginFilterChange();
 #endif
     mPriorities.clear();
+    clearAcceptedRows();
     for (const QString &eachPriority : priorities) {
         if (eachPriority == i18nc("priority is unspecified", "unspecified")) {
             mPriorities.append(i18n("%1", 0));
@@ -176,70 +332,69 @@ void TodoViewSortFilterProxyModel::setPriorityFilter(const QStringList &prioriti
 #endif
 }
 
-int TodoViewSortFilterProxyModel::compareStartDates(const QModelIndex &left, const QModelIndex &right) const
+void TodoViewSortFilterProxyModel::setSearchText(const QString &text)
 {
-    Q_ASSERT(left.column() == Akonadi::TodoModel::StartDateColumn);
-    Q_ASSERT(right.column() == Akonadi::TodoModel::StartDateColumn);
-
-    // The start date column is a QString, so fetch the to-do.
-    // We can't compare QStrings because it won't work if the format is MM/DD/YYYY
-    const auto leftTodo = left.data(Akonadi::TodoModel::TodoPtrRole).value<KCalendarCore::Todo::Ptr>();
-    const auto rightTodo = right.data(Akonadi::TodoModel::TodoPtrRole).value<KCalendarCore::Todo::Ptr>();
-
-    if (!leftTodo || !rightTodo) {
-        return 0;
+    // Plain words are looked for in the cached summaries. Patterns using
+    // regular expression syntax still go through QSortFilterProxyModel.
+    static const QRegularExpression regExpSyntax(QStringLiteral("[\\\\^$.|?*+()\\[\\]{}]"));
+    const bool literal = !text.contains(regExpSyntax);
+
+    clearAcceptedRows();
+    if (!literal) {
+        mSearchText.clear();
+        mSearchMatches.clear();
+        mPreviousSearchMatches.clear();
+        setFilterRegularExpression(text);
+        return;
     }
 
-    const bool leftIsEmpty = !leftTodo->hasStartDate();
-    const bool rightIsEmpty = !rightTodo->hasStartDate();
-
-    if (leftIsEmpty != rightIsEmpty) { // One of them doesn't have a start date
-        // For sorting, no date is considered a very big date
-        return rightIsEmpty ? -1 : 1;
-    } else if (!leftIsEmpty) { // Both have start dates
-        const auto leftDateTime = leftTodo->dtStart();
-        const auto rightDateTime = rightTodo->dtStart();
-
-        if (leftDateTime == rightDateTime) {
-            return 0;
-        } else {
-            return leftDateTime < rightDateTime ? -1 : 1;
-        }
-    } else { // Neither has a start date
-        return 0;
+    // Dropping a previous regular expression filters again on its own
+    const bool hadRegularExpression = !filterRegularExpression().pattern().isEmpty();
+#if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
+    if (!hadRegularExpression) {
+        beginFilterChange();
+    }
+#endif
+    // When the text only gets longer, rows which didn't match can't match
+    // now, so only the previous matches are checked again
+    const bool narrowing = !mSearchText.isEmpty() && text.contains(mSearchText, filterCaseSensitivity());
+    if (narrowing) {
+        mPreviousSearchMatches = std::move(mSearchMatches);
+    } else {
+        mPreviousSearchMatches.clear();
+    }
+    mSearchMatches.clear();
+    mSearchText = text;
+    if (hadRegularExpression) {
+        setFilterRegularExpression(QString());
+        return;
     }
+#if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
+    endFilterChange(QSortFilterProxyModel::Direction::Rows);
+#else
+    invalidateFilter();
+#endif
 }
 
-int TodoViewSortFilterProxyModel::compareCompletedDates(const QModelIndex &left, const QModelIndex &right) const
+bool TodoViewSortFilterProxyModel::matchesSearchText(int source_row, const QModelIndex &source_parent) const
 {
-    Q_ASSERT(left.column() == Akonadi::TodoModel::CompletedDateColumn);
-    Q_ASSERT(right.column() == Akonadi::TodoModel::CompletedDateColumn);
-
-    const auto leftTodo = left.data(Akonadi::TodoModel::TodoPtrRole).value<KCalendarCore::Todo::Ptr>();
-    const auto rightTodo = right.data(Akonadi::TodoModel::TodoPtrRole).value<KCalendarCore::Todo::Ptr>();
-
-    if (!leftTodo || !rightTodo) {
-        return 0;
+    if (mSearchText.isEmpty()) {
+        return QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
     }
 
-    const bool leftIsEmpty = !leftTodo->hasCompletedDate();
-    const bool rightIsEmpty = !rightTodo->hasCompletedDate();
-
-    if (leftIsEmpty != rightIsEmpty) { // One of them doesn't have a completed date.
-        // For sorting, no date is considered a very big date.
-        return rightIsEmpty ? -1 : 1;
-    } else if (!leftIsEmpty) { // Both have completed dates.
-        const auto leftDateTime = leftTodo->completed();
-        const auto rightDateTime = rightTodo->completed();
+    const QModelIndex index = sourceModel()->index(source_row, filterKeyColumn(), source_parent);
+    const auto it = mSearchMatches.constFind(index);
+    if (it != mSearchMatches.cend()) {
+        return it.value();
+    }
 
-        if (leftDateTime == rightDateTime) {
-            return 0;
-        } else {
-            return leftDateTime < rightDateTime ? -1 : 1;
-        }
-    } else { // Neither has a completed date.
-        return 0;
+    bool matches = false;
+    const auto previous = mPreviousSearchMatches.constFind(index);
+    if (previous == mPreviousSearchMatches.cend() || previous.value()) {
+        matches = index.data(filterRole()).toString().contains(mSearchText, filterCaseSensitivity());
     }
+    mSearchMatches.insert(index, matches);
+    return matches;
 }
 
 void TodoViewSortFilterProxyModel::setCategoryFilter(const QStringList &categories)
@@ -249,6 +404,7 @@ void TodoViewSortFilterProxyModel::setCategoryFilter(const QStringList &categori
         beginFilterChange();
 #endif
         mCategories = categories;
+        clearAcceptedRows();
 #if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
         endFilterChange(QSortFilterProxyModel::Direction::Rows);
 #else
@@ -264,6 +420,7 @@ void TodoViewSortFilterProxyModel::setCalFilter(KCalendarCore::CalFilter *filter
         beginFilterChange();
 #endif
         mCalFilter = filter;
+        clearAcceptedRows();
 #if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
         endFilterChange(QSortFilterProxyModel::Direction::Rows);
 #else
@@ -276,88 +433,99 @@ void TodoViewSortFilterProxyModel::setCalFilter(KCalendarCore::CalFilter *filter
  *  0 - equal
  *  1 - bigger than
  */
-int TodoViewSortFilterProxyModel::compareDueDates(const QModelIndex &left, const QModelIndex &right) const
+int TodoViewSortFilterProxyModel::compareStartDates(const SortKey &left, const SortKey &right)
 {
-    Q_ASSERT(left.column() == Akonadi::TodoModel::DueDateColumn);
-    Q_ASSERT(right.column() == Akonadi::TodoModel::DueDateColumn);
-
-    // The due date column is a QString, so fetch the to-do.
+    // The start date column is a QString, so the key has the to-do's date.
     // We can't compare QStrings because it won't work if the format is MM/DD/YYYY
-    const auto leftTodo = left.data(Akonadi::TodoModel::TodoPtrRole).value<KCalendarCore::Todo::Ptr>();
-    const auto rightTodo = right.data(Akonadi::TodoModel::TodoPtrRole).value<KCalendarCore::Todo::Ptr>();
-    Q_ASSERT(leftTodo);
-    Q_ASSERT(rightTodo);
-
-    if (!leftTodo || !rightTodo) {
+    if (!left.hasTodo || !right.hasTodo) {
         return 0;
     }
 
-    const bool leftIsEmpty = !leftTodo->hasDueDate();
-    const bool rightIsEmpty = !rightTodo->hasDueDate();
-
-    if (leftIsEmpty != rightIsEmpty) { // One of them doesn't have a due date
+    if (left.hasStartDate != right.hasStartDate) { // One of them doesn't have a start date
         // For sorting, no date is considered a very big date
-        return rightIsEmpty ? -1 : 1;
-    } else if (!leftIsEmpty) { // Both have due dates
-        const auto leftDateTime = leftTodo->dtDue();
-        const auto rightDateTime = rightTodo->dtDue();
+        return right.hasStartDate ? -1 : 1;
+    } else if (left.hasStartDate) { // Both have start dates
+        if (left.startDate == right.startDate) {
+            return 0;
+        } else {
+            return left.startDate < right.startDate ? -1 : 1;
+        }
+    } else { // Neither has a start date
+        return 0;
+    }
+}
+
+int TodoViewSortFilterProxyModel::compareCompletedDates(const SortKey &left, const SortKey &right)
+{
+    if (!left.hasTodo || !right.hasTodo) {
+        return 0;
+    }
 
-        if (leftDateTime == rightDateTime) {
+    if (left.hasCompletedDate != right.hasCompletedDate) { // One of them doesn't have a completed date.
+        // For sorting, no date is considered a very big date.
+        return right.hasCompletedDate ? -1 : 1;
+    } else if (left.hasCompletedDate) { // Both have completed dates.
+        if (left.completedDate == right.completedDate) {
             return 0;
         } else {
-            return leftDateTime < rightDateTime ? -1 : 1;
+            return left.completedDate < right.completedDate ? -1 : 1;
         }
-    } else { // Neither has a due date
+    } else { // Neither has a completed date.
         return 0;
     }
 }
 
-/* -1 - less than
- *  0 - equal
- *  1 - bigger than
- */
-int TodoViewSortFilterProxyModel::compareCompletion(const QModelIndex &left, const QModelIndex &right) const
+int TodoViewSortFilterProxyModel::compareDueDates(const SortKey &left, const SortKey &right)
 {
-    Q_ASSERT(left.column() == Akonadi::TodoModel::PercentColumn);
-    Q_ASSERT(right.column() == Akonadi::TodoModel::PercentColumn);
+    // The due date column is a QString, so the key has the to-do's date.
+    // We can't compare QStrings because it won't work if the format is MM/DD/YYYY
+    Q_ASSERT(left.hasTodo);
+    Q_ASSERT(right.hasTodo);
 
-    const int leftValue = sourceModel()->data(left).toInt();
-    const int rightValue = sourceModel()->data(right).toInt();
+    if (!left.hasTodo || !right.hasTodo) {
+        return 0;
+    }
 
-    if (leftValue == 100 && rightValue == 100) {
+    if (left.hasDueDate != right.hasDueDate) { // One of them doesn't have a due date
+        // For sorting, no date is considered a very big date
+        return right.hasDueDate ? -1 : 1;
+    } else if (left.hasDueDate) { // Both have due dates
+        if (left.dueDate == right.dueDate) {
+            return 0;
+        } else {
+            return left.dueDate < right.dueDate ? -1 : 1;
+        }
+    } else { // Neither has a due date
+        return 0;
+    }
+}
+
+int TodoViewSortFilterProxyModel::compareCompletion(const SortKey &left, const SortKey &right)
+{
+    if (left.percent == 100 && right.percent == 100) {
         // Break ties with the completion date.
-        const auto leftTodo = left.data(Akonadi::TodoModel::TodoPtrRole).value<KCalendarCore::Todo::Ptr>();
-        const auto rightTodo = right.data(Akonadi::TodoModel::TodoPtrRole).value<KCalendarCore::Todo::Ptr>();
-        Q_ASSERT(leftTodo);
-        Q_ASSERT(rightTodo);
-        if (!leftTodo || !rightTodo) {
+        Q_ASSERT(left.hasTodo);
+        Q_ASSERT(right.hasTodo);
+        if (!left.hasTodo || !right.hasTodo) {
             return 0;
         } else {
-            return (leftTodo->completed() > rightTodo->completed()) ? -1 : 1;
+            return (left.completedDate > right.completedDate) ? -1 : 1;
         }
     } else {
-        return (leftValue < rightValue) ? -1 : 1;
+        return (left.percent < right.percent) ? -1 : 1;
     }
 }
 
-/* -1 - less than
- *  0 - equal
- *  1 - bigger than
- * Sort in numeric order (1 < 9) rather than priority order (lowest 9 < highest 1).
+/* Sort in numeric order (1 < 9) rather than priority order (lowest 9 < highest 1).
  * There are arguments either way, but this is consistent with KCalendarCore.
  */
-int TodoViewSortFilterProxyModel::comparePriorities(const QModelIndex &left, const QModelIndex &right) const
+int TodoViewSortFilterProxyModel::comparePriorities(const SortKey &left, const SortKey &right)
 {
-    Q_ASSERT(left.isValid());
-    Q_ASSERT(right.isValid());
-
-    const auto leftTodo = left.data(Akonadi::TodoModel::TodoPtrRole).value<KCalendarCore::Todo::Ptr>();
-    const auto rightTodo = right.data(Akonadi::TodoModel::TodoPtrRole).value<KCalendarCore::Todo::Ptr>();
-    Q_ASSERT(leftTodo);
-    Q_ASSERT(rightTodo);
-    if (!leftTodo || !rightTodo || leftTodo->priority() == rightTodo->priority()) {
+    Q_ASSERT(left.hasTodo);
+    Q_ASSERT(right.hasTodo);
+    if (!left.hasTodo || !right.hasTodo || left.priority == right.priority) {
         return 0;
-    } else if (leftTodo->priority() < rightTodo->priority()) {
+    } else if (left.priority < right.priority) {
         return -1;
     } else {
         return 1;
@@ -10,6 +10,8 @@
 
 #include "prefs.h"
 
+#include <QHash>
+#include <QRegularExpression>
 #include <QSortFilterProxyModel>
 #include <QStringList>
 
@@ -26,6 +28,7 @@ public:
     explicit TodoViewSortFilterProxyModel(const EventViews::PrefsPtr &prefs, QObject *parent = nullptr);
 
     void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
 
     [[nodiscard]] const QStringList &categories() const
     {
@@ -50,16 +53,73 @@ public Q_SLOTS:
     void setCalFilter(KCalendarCore::CalFilter *filter);
     void setCategoryFilter(const QStringList &categories);
     void setPriorityFilter(const QStringList &priorities);
+    void setSearchText(const QString &text);
 
 private:
-    int compareStartDates(const QModelIndex &left, const QModelIndex &right) const;
-    int compareDueDates(const QModelIndex &left, const QModelIndex &right) const;
-    int compareCompletedDates(const QModelIndex &left, const QModelIndex &right) const;
-    int comparePriorities(const QModelIndex &left, const QModelIndex &right) const;
-    int compareCompletion(const QModelIndex &left, const QModelIndex &right) const;
+    enum class RowMatch {
+        Accepted,
+        Rejected, // still shown if one of its descendants is accepted
+        Hidden, // never shown
+    };
+
+    // Whether the row passes the filters itself, without looking at its children
+    RowMatch rowMatchesFilters(int source_row, const QModelIndex &source_parent) const;
+    bool matchesSearchText(int source_row, const QModelIndex &source_parent) const;
+    void clearAcceptedRows();
+    // Forgets the cached filter results if the base class filter changed
+    // since they were computed, e.g. through setFilterFixedString()
+    void checkBaseFilter() const;
+
+    // What lessThan() compares of a source row, read once from the model
+    struct SortKey {
+        QVariant columnValue; // sort role data of the sort column
+        QVariant columnDisplay;
+        QVariant summaryValue; // sort role data of the summary, to break ties
+        int percent = 0;
+        bool hasTodo = false;
+        int priority = 0;
+        bool hasDueDate = false;
+        bool hasStartDate = false;
+        bool hasCompletedDate = false;
+        qint64 dueDate = 0; // msecs since epoch
+        qint64 startDate = 0;
+        qint64 completedDate = 0;
+    };
+
+    const SortKey &sortKey(const QModelIndex &index) const;
+    void clearSortKeys();
+    void clearRowCaches();
+    static int compareStartDates(const SortKey &left, const SortKey &right);
+    static int compareDueDates(const SortKey &left, const SortKey &right);
+    static int compareCompletedDates(const SortKey &left, const SortKey &right);
+    static int comparePriorities(const SortKey &left, const SortKey &right);
+    static int compareCompletion(const SortKey &left, const SortKey &right);
     QStringList mCategories;
     QStringList mPriorities;
     KCalendarCore::CalFilter *mCalFilter = nullptr;
     Qt::SortOrder mSortOrder = Qt::AscendingOrder;
     EventViews::PrefsPtr mPreferences;
+
+    // filterAcceptsRow() results of the current filters, by source summary
+    // index. A parent is accepted when one of its descendants is, so each
+    // subtree is only walked once.
+    mutable QHash<QModelIndex, bool> mAcceptedRows;
+
+    // The base class filter the cached results were computed with. Its
+    // setters aren't virtual, so they are detected in filterAcceptsRow().
+    mutable QRegularExpression mBaseFilterExpression;
+    mutable int mBaseFilterKeyColumn = 0;
+    mutable int mBaseFilterRole = Qt::DisplayRole;
+
+    // Quick search without regular expression syntax, see setSearchText().
+    // Whether the summary contains mSearchText, by source summary index,
+    // and the same for the previous, shorter, text.
+    QString mSearchText;
+    mutable QHash<QModelIndex, bool> mSearchMatches;
+    mutable QHash<QModelIndex, bool> mPreviousSearchMatches;
+    QList<QMetaObject::Connection> mSourceConnections;
+
+    // Sort keys by source summary index, for the column mSortKeyColumn
+    mutable QHash<QModelIndex, SortKey> mSortKeys;
+    mutable int mSortKeyColumn = -1;
 };
@@ -14,6 +14,7 @@ using namespace Qt::Literals::StringLiterals;
 #include "agenda/agendaview.h"
 #include "calendarview_debug.h"
 #include "month/monthview.h"
+#include "month/yearview.h"
 #include "multiagenda/multiagendaview.h"
 #include "prefs.h"
 #include "timeline/timelineview.h"
@@ -72,6 +73,8 @@ void MainWindow::addView(const QString &viewName)
         eventView = new MultiAgendaView(this);
     } else if (viewName == "month"_L1) {
         eventView = new MonthView(MonthView::Visible, this);
+    } else if (viewName == "year"_L1) {
+        eventView = new YearView(this);
     } else if (viewName == "timeline"_L1) {
         eventView = new TimelineView(this);
     }